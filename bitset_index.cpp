@@ -0,0 +1,100 @@
+#include "bitset_index.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "memory_usage.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace bitset_index {
+
+using namespace std::literals;
+
+namespace {
+
+const size_t WORD_BITS = 64;
+
+uint32_t CountTrailingZeros(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+}
+
+}  // namespace
+
+BitMatrix::BitMatrix(size_t rows, size_t cols)
+    : rows_(rows), cols_(cols), words_per_row_((cols + WORD_BITS - 1) / WORD_BITS), words_(rows * words_per_row_, 0) {}
+
+void BitMatrix::Set(size_t row, size_t col) {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Bit matrix index out of range"s);
+    }
+    words_[row * words_per_row_ + col / WORD_BITS] |= uint64_t{1} << (col % WORD_BITS);
+}
+
+bool BitMatrix::Test(size_t row, size_t col) const {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Bit matrix index out of range"s);
+    }
+    return (words_[row * words_per_row_ + col / WORD_BITS] >> (col % WORD_BITS)) & 1;
+}
+
+size_t BitMatrix::Rows() const { return rows_; }
+
+size_t BitMatrix::Cols() const { return cols_; }
+
+bool BitMatrix::Empty() const { return rows_ == 0; }
+
+size_t BitMatrix::MemoryUsage() const { return memory_usage::VectorBytes(words_); }
+
+std::vector<uint64_t> BitMatrix::AndRows(const std::vector<size_t>& rows) const {
+    if (rows.empty()) {
+        return std::vector<uint64_t>(words_per_row_, 0);
+    }
+    const uint64_t* first = Row(rows.front());
+    std::vector<uint64_t> ret(first, first + words_per_row_);
+    for (size_t i = 1; i < rows.size(); ++i) {
+        const uint64_t* row = Row(rows[i]);
+        for (size_t word = 0; word < words_per_row_; ++word) {
+            ret[word] &= row[word];
+        }
+    }
+    return ret;
+}
+
+std::vector<uint64_t> BitMatrix::OrRows(const std::vector<size_t>& rows) const {
+    std::vector<uint64_t> ret(words_per_row_, 0);
+    for (const size_t row_index : rows) {
+        const uint64_t* row = Row(row_index);
+        for (size_t word = 0; word < words_per_row_; ++word) {
+            ret[word] |= row[word];
+        }
+    }
+    return ret;
+}
+
+const uint64_t* BitMatrix::Row(size_t row) const {
+    if (row >= rows_) {
+        throw std::out_of_range("Bit matrix row out of range"s);
+    }
+    return words_.data() + row * words_per_row_;
+}
+
+std::vector<uint32_t> SetBits(const std::vector<uint64_t>& words) {
+    std::vector<uint32_t> ret;
+    for (size_t i = 0; i < words.size(); ++i) {
+        for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+            ret.push_back(static_cast<uint32_t>(i * WORD_BITS) + CountTrailingZeros(word));
+        }
+    }
+    return ret;
+}
+
+}  // namespace bitset_index
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bitset_index {
+
+// Плотная битовая матрица rows x cols. Строка хранится подряд в words_per_row 64-битных словах,
+// поэтому пересечение и объединение строк выполняются пословно.
+class BitMatrix {
+   public:
+    BitMatrix() = default;
+
+    BitMatrix(size_t rows, size_t cols);
+
+    void Set(size_t row, size_t col);
+
+    bool Test(size_t row, size_t col) const;
+
+    size_t Rows() const;
+
+    size_t Cols() const;
+
+    bool Empty() const;
+
+    size_t MemoryUsage() const;
+
+    // Пересечение (AND) и объединение (OR) перечисленных строк. Для пустого списка — пустое множество
+    std::vector<uint64_t> AndRows(const std::vector<size_t>& rows) const;
+
+    std::vector<uint64_t> OrRows(const std::vector<size_t>& rows) const;
+
+   private:
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t words_per_row_ = 0;
+    std::vector<uint64_t> words_;
+
+    const uint64_t* Row(size_t row) const;
+};
+
+// Номера установленных битов по возрастанию
+std::vector<uint32_t> SetBits(const std::vector<uint64_t>& words);
+
+}  // namespace bitset_index
@@ -1,16 +1,20 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <unordered_set>
-#include <deque>
+#include <vector>
 
 #include "geo.h"
 
 namespace transport_routine::domain {
 
+// Идентификатор остановки — её порядковый номер в каталоге
+using StopId = uint32_t;
+
 struct Stop {
     std::string name;
     geo::Coordinates point;
+    StopId id = 0;
 };
 
 struct StopPtrComparatorLess {
@@ -19,9 +23,21 @@ struct StopPtrComparatorLess {
 
 struct Bus {
     std::string name;
-    std::unordered_set<const Stop*> unique_stops;
-    std::deque<const Stop*> route;
+    std::vector<StopId> route;
+    int unique_stop_count = 0;
     bool is_roundtrip = false;
+    // Накопленные расстояния, заполняются каталогом при добавлении маршрута.
+    // road_distances[i] — путь по дорогам от route.front() до route[i],
+    // road_distances_back[i] — путь в обратном направлении от route.back() до route[size - 1 - i]
+    // (только для некольцевых маршрутов),
+    // geo_distances[i] — сумма расстояний по прямой от route.front() до route[i], одинаковая в обе стороны.
+    std::vector<double> road_distances;
+    std::vector<double> road_distances_back;
+    std::vector<double> geo_distances;
+    // Длина всего маршрута по дорогам и по прямой. Некольцевой маршрут проходится туда и обратно с разворотом
+    // на конечной (расстояние от последней остановки до неё самой), расстояния суммируются в порядке обхода
+    double total_road_distance = .0;
+    double total_geo_distance = .0;
 };
 
 struct BusPtrComparatorLess {
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <vector>
 
+#include "memory_usage.h"
 #include "ranges.h"
 
 namespace graph {
@@ -36,6 +37,8 @@ class DirectedWeightedGraph {
     const std::vector<Edge<Weight>>& GetEdges() const;
     const std::vector<IncidenceList>& GetIncidenceLists() const;
 
+    memory_usage::MemoryReport MemoryUsage() const;
+
    private:
     std::vector<Edge<Weight>> edges_;
     std::vector<IncidenceList> incidence_lists_;
@@ -89,4 +92,16 @@ DirectedWeightedGraph<Weight>::GetIncidenceLists() const {
     return incidence_lists_;
 }
 
+template <typename Weight>
+memory_usage::MemoryReport DirectedWeightedGraph<Weight>::MemoryUsage() const {
+    memory_usage::MemoryReport ret;
+    ret.Add("edges", memory_usage::VectorBytes(edges_));
+    size_t incidence_bytes = memory_usage::VectorBytes(incidence_lists_);
+    for (const IncidenceList& incidence_list : incidence_lists_) {
+        incidence_bytes += memory_usage::VectorBytes(incidence_list);
+    }
+    ret.Add("incidence_lists", incidence_bytes);
+    return ret;
+}
+
 }  // namespace graph
\ No newline at end of file
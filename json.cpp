@@ -1,280 +1,410 @@
 #include "json.h"
 
+#include <charconv>
+#include <exception>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "json_scan.h"
+#include "parallel.h"
+#include "number_format.h"
+
 using namespace std;
 
 namespace json {
 
 namespace detail {
 
-Node LoadNode(istream& input);
-
-std::istreambuf_iterator<char> ParseEmptySpace(std::istream& input) {
-    char c;
-    if (!(input >> c)) {
-        throw json::ParsingError("Unexpected end of file"s);
+// Разбор документа из буфера в памяти. Позиция — указатель в буфере, символы читаются без потоков.
+// Строки без escape-последовательностей копируются в узел одним куском.
+class Parser {
+public:
+    Parser(std::string_view buffer, std::pmr::memory_resource* resource)
+            : pos_(buffer.data()), end_(buffer.data() + buffer.size()), resource_(resource) {
     }
-    input.putback(c);
-    return {input};
-}
 
-Node LoadArray(istream& input) {
-    Array result;
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    bool not_a_first_value = false;
-
-    while (true) {
-        if (it == end) {
-            throw json::ParsingError("Array parsing error"s);
+    Node LoadNode() {
+        const char c = SkipSpaceAndPeek();
+        if (c == '[') {
+            ++pos_;
+            return LoadArray();
+        } else if (c == '{') {
+            ++pos_;
+            return LoadDict();
+        } else if (c == '"') {
+            ++pos_;
+            return {LoadString()};
+        } else if (c == 't') {
+            return LoadLiteral("true"sv, true, "Invalid boolean value"s);
+        } else if (c == 'f') {
+            return LoadLiteral("false"sv, false, "Invalid boolean value"s);
+        } else if (c == 'n') {
+            return LoadLiteral("null"sv, nullptr, "Unknown value"s);
+        } else if (c == '-' || IsDigit(c)) {
+            return LoadNumber();
         }
-        it = ParseEmptySpace(input);
+        throw json::ParsingError("Unexpected lexeme"s);
+    }
 
-        if (*it == ']') {
-            ++it;
-            break;
-        }
-        if (not_a_first_value && *it != ',') {
-            throw json::ParsingError(", expected"s);
-        } else if (not_a_first_value && *it == ',') {
-            ++it;
-        }
-        result.push_back(LoadNode(input));
-        not_a_first_value = true;
+    Node LoadStreamingRoot(const std::string& streamed_key, const ItemHandler& on_item) {
+        return LoadRootWithArray(streamed_key, [this, &streamed_key, &on_item] {
+            LoadArrayItems([&streamed_key, &on_item](Node item) {
+                on_item(streamed_key, std::move(item));
+            });
+        });
     }
 
-    return {std::move(result)};
-}
+    Node LoadParallelRoot(const std::string& split_key, size_t range_count, const RangeItemHandler& on_item) {
+        return LoadRootWithArray(split_key, [this, range_count, &on_item] {
+            // Быстрый просмотр находит начало каждого элемента, не строя узлов
+            std::vector<const char*> starts;
+            LoadArrayItemBounds(starts);
+            LoadRanges(starts, range_count, on_item);
+        });
+    }
 
-Node LoadNumber(std::istream& input) {
-    using namespace std::literals;
+private:
+    const char* pos_;
+    const char* end_;
+    // Память для массивов и словарей разбираемого дерева
+    std::pmr::memory_resource* resource_;
 
-    std::string parsed_num;
+    static bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
 
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw json::ParsingError("Failed to read number from stream"s);
+    // Пропускает пробельные символы и возвращает первый значащий, не сдвигая позицию
+    char SkipSpaceAndPeek() {
+        pos_ = scan::SkipSpaces(pos_, end_);
+        if (pos_ == end_) {
+            throw json::ParsingError("Unexpected end of file"s);
         }
-    };
+        return *pos_;
+    }
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
-            throw json::ParsingError("A digit is expected"s);
-        }
-        while (std::isdigit(input.peek())) {
-            read_char();
+    // Разбирает словарь в корне документа. Массив под ключом array_key не сохраняется в документе:
+    // его элементы разбирает on_array, позиция — сразу после '['. В документе по этому ключу остаётся пустой массив
+    template <typename Func>
+    Node LoadRootWithArray(const std::string& array_key, Func on_array) {
+        if (SkipSpaceAndPeek() != '{') {
+            throw json::ParsingError("Dict expected"s);
         }
-    };
-
-    if (input.peek() == '-') {
-        read_char();
-    }
-    // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
-        // После 0 в JSON не могут идти другие цифры
-    } else {
-        read_digits();
+        ++pos_;
+        Dict::Storage items(resource_);
+        LoadDictItems([this, &items, &array_key, &on_array](std::string key) {
+            if (key != array_key || SkipSpaceAndPeek() != '[') {
+                Node value = LoadNode();
+                items.emplace_back(std::move(key), std::move(value));
+                return;
+            }
+            ++pos_;
+            on_array();
+            items.emplace_back(std::move(key), Array{});
+        });
+        return {Dict(std::move(items))};
     }
 
-    bool is_int = true;
-    // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
-        read_digits();
-        is_int = false;
+    // Пропускает строковый литерал, позиция — сразу после открывающей кавычки
+    void SkipString() {
+        while (true) {
+            pos_ = scan::FindStringSpecial(pos_, end_);
+            if (pos_ == end_) {
+                throw json::ParsingError("String parsing error"s);
+            }
+            const char c = *pos_++;
+            if (c == '"') {
+                return;
+            } else if (c == '\\') {
+                if (pos_ == end_) {
+                    throw json::ParsingError("String parsing error"s);
+                }
+                ++pos_;
+            } else {
+                throw json::ParsingError("Unexpected end of line"s);
+            }
+        }
     }
 
-    // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    // Пропускает значение до запятой или закрывающей скобки на его уровне, не строя узлов.
+    // Проверяются только строки и вложенность скобок: полностью значение разбирается позже
+    void SkipValue() {
+        size_t depth = 0;
+        while (true) {
+            const char c = SkipSpaceAndPeek();
+            if (depth == 0 && (c == ',' || c == ']' || c == '}')) {
+                return;
+            }
+            ++pos_;
+            if (c == '"') {
+                SkipString();
+            } else if (c == '[' || c == '{') {
+                ++depth;
+            } else if (c == ']' || c == '}') {
+                --depth;
+            }
         }
-        read_digits();
-        is_int = false;
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return {std::stoi(parsed_num)};
+    // Находит начала элементов массива, позиция — сразу после '['. Позиция переходит за ']'
+    void LoadArrayItemBounds(std::vector<const char*>& starts) {
+        if (SkipSpaceAndPeek() == ']') {
+            ++pos_;
+            return;
+        }
+        while (true) {
+            starts.push_back(pos_);
+            SkipValue();
+            const char c = SkipSpaceAndPeek();
+            ++pos_;
+            if (c == ']') {
+                break;
             }
-            catch (...) {
-                // В случае неудачи, например, при переполнении,
-                // код ниже попробует преобразовать строку в double
+            if (c != ',') {
+                throw json::ParsingError(", expected"s);
             }
         }
-        return {std::stod(parsed_num)};
     }
-    catch (...) {
-        throw json::ParsingError("Failed to convert "s + parsed_num + " to number"s);
+
+    // Делит элементы на range_count диапазонов с равным числом элементов и разбирает диапазоны параллельно.
+    // Ошибка разбора в любом диапазоне выбрасывается после завершения всех потоков
+    void LoadRanges(const std::vector<const char*>& starts, size_t range_count, const RangeItemHandler& on_item) {
+        const size_t count = starts.size();
+        range_count = std::clamp<size_t>(range_count, 1, std::max<size_t>(count, 1));
+        std::vector<std::exception_ptr> errors(range_count);
+        parallel::ForEachRange(0, range_count, 1, [&](size_t first_range, size_t last_range) {
+            for (size_t range = first_range; range < last_range; ++range) {
+                const size_t first = count * range / range_count;
+                const size_t last = count * (range + 1) / range_count;
+                try {
+                    if (first == last) {
+                        continue;
+                    }
+                    Parser parser(std::string_view(starts[first], end_ - starts[first]),
+                                  std::pmr::get_default_resource());
+                    for (size_t i = first; i < last; ++i) {
+                        on_item(range, parser.LoadNode());
+                        // За элементом, как и при разметке, должна следовать запятая или конец массива
+                        const char c = parser.SkipSpaceAndPeek();
+                        if (c != ',' && c != ']') {
+                            throw json::ParsingError(", expected"s);
+                        }
+                        ++parser.pos_;
+                    }
+                } catch (...) {
+                    errors[range] = std::current_exception();
+                }
+            }
+        });
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
     }
-}
 
-// Считывает содержимое строкового литерала JSON-документа
-// Функцию следует использовать после считывания открывающего символа ":
-Node LoadString(std::istream& input) {
-    using namespace std::literals;
+    // Разбирает элементы массива, позиция — сразу после '['. Каждый элемент передаётся в on_item
+    template <typename Func>
+    void LoadArrayItems(Func on_item) {
+        if (SkipSpaceAndPeek() == ']') {
+            ++pos_;
+            return;
+        }
+        while (true) {
+            on_item(LoadNode());
+            const char c = SkipSpaceAndPeek();
+            ++pos_;
+            if (c == ']') {
+                break;
+            }
+            if (c != ',') {
+                throw json::ParsingError(", expected"s);
+            }
+        }
+    }
 
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    std::string s;
-    while (true) {
-        if (it == end) {
-            // Поток закончился до того, как встретили закрывающую кавычку?
-            throw json::ParsingError("String parsing error"s);
+    // Разбирает пары словаря, позиция — сразу после '{'. Для каждого ключа вызывается on_key(key),
+    // который должен разобрать значение
+    template <typename Func>
+    void LoadDictItems(Func on_key) {
+        if (SkipSpaceAndPeek() == '}') {
+            ++pos_;
+            return;
         }
-        const char ch = *it;
-        if (ch == '"') {
-            // Встретили закрывающую кавычку
-            ++it;
-            break;
-        } else if (ch == '\\') {
-            // Встретили начало escape-последовательности
-            ++it;
-            if (it == end) {
-                // Поток завершился сразу после символа обратной косой черты
-                throw json::ParsingError("String parsing error"s);
+        while (true) {
+            if (SkipSpaceAndPeek() != '"') {
+                throw json::ParsingError("\" expected"s);
+            }
+            ++pos_;
+            std::string key = LoadString();
+            if (SkipSpaceAndPeek() != ':') {
+                throw json::ParsingError(": expected"s);
             }
-            const char escaped_char = *(it);
-            // Обрабатываем одну из последовательностей: \\, \n, \t, \r, \"
-            switch (escaped_char) {
-                case 'n':
-                    s.push_back('\n');
-                    break;
-                case 't':
-                    s.push_back('\t');
-                    break;
-                case 'r':
-                    s.push_back('\r');
-                    break;
-                case '"':
-                    s.push_back('"');
-                    break;
-                case '\\':
-                    s.push_back('\\');
-                    break;
-                default:
-                    // Встретили неизвестную escape-последовательность
-                    throw json::ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+            ++pos_;
+            on_key(std::move(key));
+            const char c = SkipSpaceAndPeek();
+            ++pos_;
+            if (c == '}') {
+                break;
+            }
+            if (c != ',') {
+                throw json::ParsingError(", expected"s);
             }
-        } else if (ch == '\n' || ch == '\r') {
-            // Строковый литерал внутри- JSON не может прерываться символами \r или \n
-            throw json::ParsingError("Unexpected end of line"s);
-        } else {
-            // Просто считываем очередной символ и помещаем его в результирующую строку
-            s.push_back(ch);
         }
-        ++it;
     }
 
-    return {std::move(s)};
-}
+    Node LoadArray() {
+        Array result(resource_);
+        LoadArrayItems([&result](Node item) {
+            result.push_back(std::move(item));
+        });
+        return {std::move(result)};
+    }
 
-Node LoadBool(istream& input) {
-    char c;
-    input >> c;
+    Node LoadDict() {
+        // Пары собираются в порядке документа и упорядочиваются один раз
+        Dict::Storage items(resource_);
+        LoadDictItems([this, &items](std::string key) {
+            Node value = LoadNode();
+            items.emplace_back(std::move(key), std::move(value));
+        });
+        return {Dict(std::move(items))};
+    }
 
-    if (c == 't') {
-        input.putback(c);
-        char str[4];
-        input.read(str, 4);
-        if (string(str, 4) != "true"s) {
-            throw json::ParsingError("Invalid boolean value"s);
-        };
-        return {true};
-    } else if (c == 'f') {
-        input.putback(c);
-        char str[5];
-        input.read(str, 5);
-        if (string(str, 5) != "false"s) {
-            throw json::ParsingError("Invalid boolean value"s);
+    Node LoadLiteral(std::string_view literal, Node value, const std::string& error) {
+        if (static_cast<size_t>(end_ - pos_) < literal.size() || std::string_view(pos_, literal.size()) != literal) {
+            throw json::ParsingError(error);
         }
-        return {false};
+        pos_ += literal.size();
+        return value;
     }
 
-    throw json::ParsingError("Unknown lexeme"s);
-}
+    Node LoadNumber() {
+        const char* const first = pos_;
 
-Node LoadNull(istream& input) {
-    char str[4];
-    input.read(str, 4);
-    if (string(str, 4) != "null"s) {
-        throw json::ParsingError("Unknown value"s);
-    }
+        // Считывает одну или более цифр
+        auto read_digits = [this] {
+            if (pos_ == end_ || !IsDigit(*pos_)) {
+                throw json::ParsingError("A digit is expected"s);
+            }
+            while (pos_ != end_ && IsDigit(*pos_)) {
+                ++pos_;
+            }
+        };
 
-    return {nullptr};
-}
+        if (*pos_ == '-') {
+            ++pos_;
+        }
+        // Парсим целую часть числа. После 0 в JSON не могут идти другие цифры
+        if (pos_ != end_ && *pos_ == '0') {
+            ++pos_;
+        } else {
+            read_digits();
+        }
 
-Node LoadDict(istream& input) {
-    Dict result;
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    bool not_a_first_key = false;
+        bool is_int = true;
+        // Парсим дробную часть числа
+        if (pos_ != end_ && *pos_ == '.') {
+            ++pos_;
+            read_digits();
+            is_int = false;
+        }
 
-    while (true) {
-        if (it == end) {
-            throw json::ParsingError("Dict parsing error"s);
+        // Парсим экспоненциальную часть числа
+        if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+            if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) {
+                ++pos_;
+            }
+            read_digits();
+            is_int = false;
         }
-        it = ParseEmptySpace(input);
-        if (*it == '}') {
-            ++it;
-            break;
+
+        if (is_int) {
+            // Сначала пробуем преобразовать строку в int. При переполнении число читается как double
+            int value = 0;
+            const auto [ptr, ec] = std::from_chars(first, pos_, value);
+            if (ec == std::errc() && ptr == pos_) {
+                return {value};
+            }
         }
-        if (not_a_first_key && *it != ',') {
-            throw json::ParsingError(", expected"s);
-        } else if (not_a_first_key && *it == ',') {
-            ++it;
+        double value = .0;
+        const auto [ptr, ec] = std::from_chars(first, pos_, value);
+        if (ec != std::errc() || ptr != pos_) {
+            throw json::ParsingError("Failed to convert "s + std::string(first, pos_) + " to number"s);
         }
-        it = ParseEmptySpace(input);
-        if (*it != '\"') {
-            throw json::ParsingError("\" expected"s);
-        } else {
-            ++it;
-            string key = LoadString(input).AsString();
-            it = ParseEmptySpace(input);
-            if (*it != ':') {
-                throw json::ParsingError(": expected"s);
+        return {value};
+    }
+
+    // Считывает содержимое строкового литерала, позиция — сразу после открывающей кавычки
+    std::string LoadString() {
+        // Быстрый путь: строка без escape-последовательностей
+        const char* const first = pos_;
+        pos_ = scan::FindStringSpecial(pos_, end_);
+        if (pos_ != end_ && *pos_ == '"') {
+            return std::string(first, pos_++);
+        }
+
+        // Участки между escape-последовательностями копируются целиком
+        std::string s(first, pos_);
+        while (true) {
+            const char* const special = scan::FindStringSpecial(pos_, end_);
+            s.append(pos_, special);
+            pos_ = special;
+            if (pos_ == end_) {
+                // Буфер закончился до того, как встретили закрывающую кавычку
+                throw json::ParsingError("String parsing error"s);
+            }
+            const char ch = *pos_++;
+            if (ch == '"') {
+                break;
+            } else if (ch == '\\') {
+                if (pos_ == end_) {
+                    throw json::ParsingError("String parsing error"s);
+                }
+                const char escaped_char = *pos_++;
+                // Обрабатываем одну из последовательностей: \\, \n, \t, \r, \"
+                switch (escaped_char) {
+                    case 'n':
+                        s.push_back('\n');
+                        break;
+                    case 't':
+                        s.push_back('\t');
+                        break;
+                    case 'r':
+                        s.push_back('\r');
+                        break;
+                    case '"':
+                        s.push_back('"');
+                        break;
+                    case '\\':
+                        s.push_back('\\');
+                        break;
+                    default:
+                        throw json::ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+                }
             } else {
-                ++it;
-                result.insert({std::move(key), LoadNode(input)});
-                not_a_first_key = true;
+                // Строковый литерал внутри JSON не может прерываться символами \r или \n
+                throw json::ParsingError("Unexpected end of line"s);
             }
         }
+        return s;
     }
+};
 
-    return {std::move(result)};
+void PrintValue(int value, const PrintContext& ctx) {
+    number_format::WriteInt(ctx.out, value);
 }
 
-Node LoadNode(istream& input) {
-    char c;
-
-    if (!(input >> c)) {
-        throw json::ParsingError("Unexpected end of file"s);
-    }
-
-    if (c == '[') {
-        return LoadArray(input);
-    } else if (c == '{') {
-        return LoadDict(input);
-    } else if (c == '"') {
-        return LoadString(input);
-    } else if (c == 't' || c == 'f') {
-        input.putback(c);
-        return LoadBool(input);
-    } else if (c == 'n') {
-        input.putback(c);
-        return LoadNull(input);
-    } else if (c == '-' || std::isdigit(c)) {
-        input.putback(c);
-        return LoadNumber(input);
-    } else {
-        throw json::ParsingError("Unexpected lexeme"s);
-    }
+void PrintValue(double value, const PrintContext& ctx) {
+    number_format::WriteDouble(ctx.out, value);
 }
 
 // Перегрузка функции PrintValue для вывода значений null
@@ -294,19 +424,21 @@ void PrintValue(bool value, const PrintContext& ctx) {
 
 void PrintValue(const Array& array, const PrintContext& ctx) {
     auto& out = ctx.out;
-    out << "[\n"sv;
+    out << "["sv;
+    ctx.PrintLineBreak();
     bool IsFirst = true;
     auto inner_ctx = ctx.Indented();
     for (auto it = array.begin(); it != array.end(); ++it) {
         if (IsFirst) {
             IsFirst = false;
         } else {
-            out << ",\n"sv;
+            out << ","sv;
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
         PrintNode(*it, ctx.Indented());
     }
-    out << "\n"sv;
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     out << "]"sv;
 }
@@ -337,7 +469,8 @@ void PrintValue(const std::string& str, const PrintContext& ctx) {
 
 void PrintValue(const Dict& dict, const PrintContext& ctx) {
     auto& out = ctx.out;
-    out << "{\n"sv;
+    out << "{"sv;
+    ctx.PrintLineBreak();
     bool IsFirst = true;
     auto inner_ctx = ctx.Indented();
     for (auto it = dict.begin(); it != dict.end(); ++it) {
@@ -345,13 +478,14 @@ void PrintValue(const Dict& dict, const PrintContext& ctx) {
         if (IsFirst) {
             IsFirst = false;
         } else {
-            out << ",\n"sv;
+            out << ","sv;
+            ctx.PrintLineBreak();
         }
         inner_ctx.PrintIndent();
-        out << "\""sv << key << "\""sv << ": ";
+        out << "\""sv << key << "\""sv << ctx.KeySeparator();
         PrintNode(value, inner_ctx);
     }
-    out << "\n"sv;
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     out << "}"sv;
 }
@@ -413,6 +547,27 @@ const Dict& Node::AsDict() const {
     return get<Dict>(*this);
 }
 
+Array& Node::AsArray() {
+    if (!IsArray()) {
+        throw std::logic_error("Value type is not Array."s);
+    }
+    return get<Array>(*this);
+}
+
+Dict& Node::AsDict() {
+    if (!IsDict()) {
+        throw std::logic_error("Value type is not Dict."s);
+    }
+    return get<Dict>(*this);
+}
+
+string& Node::AsString() {
+    if (!IsString()) {
+        throw std::logic_error("Value type is not string"s);
+    }
+    return get<std::string>(*this);
+}
+
 int Node::AsInt() const {
     if (!IsInt()) {
         throw std::logic_error("Value type is not int."s);
@@ -461,10 +616,18 @@ Document::Document(Node root)
         : root_(std::move(root)) {
 }
 
+Document::Document(Node root, std::shared_ptr<Arena> arena)
+        : arena_(std::move(arena)), root_(std::move(root)) {
+}
+
 const Node& Document::GetRoot() const {
     return root_;
 }
 
+Node& Document::GetRoot() {
+    return root_;
+}
+
 bool Document::operator==(const json::Document& other) const {
     return GetRoot() == other.GetRoot();
 }
@@ -473,8 +636,238 @@ bool Document::operator!=(const json::Document& other) const {
     return !(*this == other);
 }
 
+namespace {
+
+// До такого размера линейный просмотр быстрее двоичного поиска
+const size_t DICT_LINEAR_SEARCH_LIMIT = 8;
+
+// Наибольший первый блок арены документа
+const size_t ARENA_INITIAL_SIZE = 64 * 1024;
+
+}  // namespace
+
+Dict::Dict(std::pmr::memory_resource* resource) : items_(resource) {
+}
+
+Dict::Dict(Storage items) : items_(std::move(items)) {
+    std::stable_sort(items_.begin(), items_.end(), [](const value_type& lhs, const value_type& rhs) {
+        return lhs.first < rhs.first;
+    });
+    items_.erase(std::unique(items_.begin(), items_.end(),
+                             [](const value_type& lhs, const value_type& rhs) {
+                                 return lhs.first == rhs.first;
+                             }),
+                 items_.end());
+}
+
+Dict::iterator Dict::begin() {
+    return items_.begin();
+}
+
+Dict::iterator Dict::end() {
+    return items_.end();
+}
+
+Dict::const_iterator Dict::begin() const {
+    return items_.begin();
+}
+
+Dict::const_iterator Dict::end() const {
+    return items_.end();
+}
+
+size_t Dict::size() const {
+    return items_.size();
+}
+
+bool Dict::empty() const {
+    return items_.empty();
+}
+
+void Dict::clear() {
+    items_.clear();
+}
+
+void Dict::reserve(size_t count) {
+    items_.reserve(count);
+}
+
+Dict::const_iterator Dict::LowerBound(std::string_view key) const {
+    if (items_.size() <= DICT_LINEAR_SEARCH_LIMIT) {
+        auto it = items_.begin();
+        while (it != items_.end() && std::string_view(it->first) < key) {
+            ++it;
+        }
+        return it;
+    }
+    return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view key) {
+        return std::string_view(item.first) < key;
+    });
+}
+
+Dict::const_iterator Dict::find(std::string_view key) const {
+    const auto it = LowerBound(key);
+    return it != items_.end() && it->first == key ? it : items_.end();
+}
+
+Dict::iterator Dict::find(std::string_view key) {
+    return items_.begin() + (std::as_const(*this).find(key) - items_.cbegin());
+}
+
+size_t Dict::count(std::string_view key) const {
+    return find(key) == end() ? 0 : 1;
+}
+
+const Node& Dict::at(std::string_view key) const {
+    const auto it = find(key);
+    if (it == end()) {
+        throw std::out_of_range("Dict key not found: "s + std::string(key));
+    }
+    return it->second;
+}
+
+Node& Dict::at(std::string_view key) {
+    return const_cast<Node&>(std::as_const(*this).at(key));
+}
+
+std::pair<Dict::iterator, bool> Dict::emplace(std::string key, Node value) {
+    const auto pos = items_.begin() + (LowerBound(key) - items_.cbegin());
+    if (pos != items_.end() && pos->first == key) {
+        return {pos, false};
+    }
+    return {items_.emplace(pos, std::move(key), std::move(value)), true};
+}
+
+Node& Dict::operator[](std::string key) {
+    return emplace(std::move(key), Node{}).first->second;
+}
+
+bool Dict::operator==(const Dict& other) const {
+    return items_ == other.items_;
+}
+
+bool Dict::operator!=(const Dict& other) const {
+    return !(*this == other);
+}
+
+namespace {
+
+// Поток целиком в одной строке. Копирование через ostringstream и str() держало бы в памяти две копии входа
+std::string ReadAll(std::istream& input) {
+    std::string ret;
+    const std::istream::pos_type start = input.tellg();
+    if (start != std::istream::pos_type(-1) && input.seekg(0, std::ios::end)) {
+        ret.reserve(static_cast<size_t>(input.tellg() - start));
+        input.seekg(start);
+    } else {
+        input.clear();
+    }
+    char chunk[64 * 1024];
+    while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+        ret.append(chunk, static_cast<size_t>(input.gcount()));
+    }
+    return ret;
+}
+
+}  // namespace
+
 Document Load(istream& input) {
-    return Document{detail::LoadNode(input)};
+    return Load(std::string_view(ReadAll(input)));
+}
+
+Document Load(std::string_view buffer) {
+    // Первый блок арены ограничен: большие документы обычно разбираются потоково, а дальше арена растёт
+    // геометрически сама. Блок по размеру всего буфера резервировал бы память, которая может не понадобиться
+    auto arena = std::make_shared<Arena>(std::min(std::max<size_t>(buffer.size(), 1), ARENA_INITIAL_SIZE));
+    Node root = detail::Parser(buffer, arena.get()).LoadNode();
+    return Document{std::move(root), std::move(arena)};
+}
+
+namespace {
+
+// Разбирает содержимое файла функцией parse. На POSIX-системах файл отображается в память,
+// узлы владеют копиями строк, поэтому отображение освобождается сразу после разбора
+Document ParseFile(const std::string& path, const std::function<Document(std::string_view)>& parse) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open "s + path);
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat "s + path);
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    if (size == 0) {
+        close(fd);
+        return parse(std::string_view());
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map "s + path);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    try {
+        Document ret = parse(std::string_view(static_cast<const char*>(data), size));
+        munmap(data, size);
+        return ret;
+    } catch (...) {
+        munmap(data, size);
+        throw;
+    }
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Cannot open "s + path);
+    }
+    return parse(ReadAll(input));
+#endif
+}
+
+}  // namespace
+
+Document LoadFile(const std::string& path) {
+    return ParseFile(path, [](std::string_view buffer) {
+        return Load(buffer);
+    });
+}
+
+Document LoadStreaming(std::istream& input, const std::string& streamed_key, const ItemHandler& on_item) {
+    return LoadStreaming(std::string_view(ReadAll(input)), streamed_key, on_item);
+}
+
+Document LoadStreaming(std::string_view buffer, const std::string& streamed_key, const ItemHandler& on_item) {
+    // Элементы потокового массива разрушаются сразу после обработки, и монотонная арена копила бы их память,
+    // поэтому потоковый разбор размещает узлы в общей куче
+    return Document{detail::Parser(buffer, std::pmr::get_default_resource()).LoadStreamingRoot(streamed_key, on_item)};
+}
+
+Document LoadFileStreaming(const std::string& path, const std::string& streamed_key, const ItemHandler& on_item) {
+    return ParseFile(path, [&streamed_key, &on_item](std::string_view buffer) {
+        return LoadStreaming(buffer, streamed_key, on_item);
+    });
+}
+
+Document LoadParallel(std::istream& input, const std::string& split_key, size_t range_count,
+                      const RangeItemHandler& on_item) {
+    return LoadParallel(std::string_view(ReadAll(input)), split_key, range_count, on_item);
+}
+
+Document LoadParallel(std::string_view buffer, const std::string& split_key, size_t range_count,
+                      const RangeItemHandler& on_item) {
+    // Как и при потоковом разборе, элементы разрушаются сразу после обработки, поэтому арена не используется.
+    // Общая куча потокобезопасна, а монотонная арена — нет
+    return Document{detail::Parser(buffer, std::pmr::get_default_resource())
+                        .LoadParallelRoot(split_key, range_count, on_item)};
+}
+
+Document LoadFileParallel(const std::string& path, const std::string& split_key, size_t range_count,
+                          const RangeItemHandler& on_item) {
+    return ParseFile(path, [&split_key, range_count, &on_item](std::string_view buffer) {
+        return LoadParallel(buffer, split_key, range_count, on_item);
+    });
 }
 
 void Print(const Document& doc, std::ostream& output) {
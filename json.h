@@ -1,8 +1,11 @@
 #pragma once
 
+#include <functional>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 #include <stdexcept>
@@ -12,9 +15,73 @@
 namespace json {
 
 class Node;
-// Сохраните объявления Dict и Array без изменения
-using Dict = std::map<std::string, Node>;
-using Array = std::vector<Node>;
+
+// Словарь JSON: пары хранятся в одном непрерывном векторе, упорядоченном по ключу, поэтому обход идёт
+// в том же порядке, что и у std::map. Короткие ключи умещаются во внутреннем буфере std::string.
+// Поиск принимает std::string_view: небольшие словари просматриваются линейно, большие — двоичным поиском.
+// Указатели и итераторы на элементы становятся недействительными после вставки
+class Dict {
+public:
+    using value_type = std::pair<std::string, Node>;
+    using Storage = std::pmr::vector<value_type>;
+    using iterator = Storage::iterator;
+    using const_iterator = Storage::const_iterator;
+
+    Dict() = default;
+
+    // Пустой словарь, пары которого размещаются в resource
+    explicit Dict(std::pmr::memory_resource* resource);
+
+    // Пары в произвольном порядке. При повторе ключа остаётся первое значение, как при вставке в std::map
+    explicit Dict(Storage items);
+
+    iterator begin();
+
+    iterator end();
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    void clear();
+
+    void reserve(size_t count);
+
+    iterator find(std::string_view key);
+
+    const_iterator find(std::string_view key) const;
+
+    size_t count(std::string_view key) const;
+
+    // Бросает std::out_of_range, если ключа нет
+    Node& at(std::string_view key);
+
+    const Node& at(std::string_view key) const;
+
+    Node& operator[](std::string key);
+
+    std::pair<iterator, bool> emplace(std::string key, Node value);
+
+    bool operator==(const Dict& other) const;
+
+    bool operator!=(const Dict& other) const;
+
+private:
+    Storage items_;
+
+    // Позиция первой пары с ключом не меньше key
+    const_iterator LowerBound(std::string_view key) const;
+};
+
+// Массивы и словари хранят элементы через std::pmr: дерево документа можно целиком разместить в арене
+using Array = std::pmr::vector<Node>;
+
+// Монотонная арена для узлов одного документа: память не возвращается по узлам, а освобождается разом
+using Arena = std::pmr::monotonic_buffer_resource;
 
 // Эта ошибка должна выбрасываться при ошибках парсинга JSON
 class ParsingError : public std::runtime_error {
@@ -50,6 +117,13 @@ public:
 
     const Dict& AsDict() const;
 
+    // Изменяемый доступ, чтобы перемещать содержимое из документа
+    Array& AsArray();
+
+    Dict& AsDict();
+
+    std::string& AsString();
+
     int AsInt() const;
 
     bool AsBool() const;
@@ -71,43 +145,107 @@ class Document {
 public:
     explicit Document(Node root);
 
+    // Документ, узлы которого размещены в arena. Арена освобождается вместе с последней копией документа,
+    // копии дерева размещаются в общей куче
+    Document(Node root, std::shared_ptr<Arena> arena);
+
+    Document(const Document&) = default;
+
+    Document(Document&&) = default;
+
+    // При присваивании узлы из разных арен перемещались бы поэлементно, поэтому оно запрещено
+    Document& operator=(const Document&) = delete;
+
+    Document& operator=(Document&&) = delete;
+
     const Node& GetRoot() const;
 
+    Node& GetRoot();
+
     bool operator==(const json::Document& other) const;
 
     bool operator!=(const json::Document& other) const;
 
 private:
+    // Объявлена до корня: дерево разрушается раньше арены, в которой размещено
+    std::shared_ptr<Arena> arena_;
     Node root_;
 };
 
+// Читает поток до конца и разбирает первый JSON-документ в нём. Узлы документа размещаются в его арене
 Document Load(std::istream& input);
 
+Document Load(std::string_view buffer);
+
+// Разбирает файл целиком. На POSIX-системах файл отображается в память без копирования
+Document LoadFile(const std::string& path);
+
+// Обработчик потокового разбора: ключ корневого словаря и очередной элемент массива под этим ключом
+using ItemHandler = std::function<void(const std::string& key, Node item)>;
+
+// Разбирает документ со словарём в корне. Элементы массива под ключом streamed_key не накапливаются:
+// каждый передаётся в on_item сразу после разбора, а в документе по этому ключу остаётся пустой массив
+Document LoadStreaming(std::istream& input, const std::string& streamed_key, const ItemHandler& on_item);
+
+Document LoadStreaming(std::string_view buffer, const std::string& streamed_key, const ItemHandler& on_item);
+
+Document LoadFileStreaming(const std::string& path, const std::string& streamed_key, const ItemHandler& on_item);
+
+// Обработчик параллельного разбора: номер диапазона и очередной элемент массива
+using RangeItemHandler = std::function<void(size_t range, Node item)>;
+
+// Разбирает документ со словарём в корне. Элементы массива под ключом split_key сначала размечаются быстрым
+// просмотром без построения узлов, затем делятся на range_count непрерывных диапазонов с равным числом элементов,
+// и диапазоны разбираются параллельно. Диапазоны нумеруются по порядку в массиве. on_item вызывается одновременно
+// из нескольких потоков, но все элементы одного диапазона передаются по порядку из одного потока.
+// В документе по ключу split_key остаётся пустой массив
+Document LoadParallel(std::istream& input, const std::string& split_key, size_t range_count,
+                      const RangeItemHandler& on_item);
+
+Document LoadParallel(std::string_view buffer, const std::string& split_key, size_t range_count,
+                      const RangeItemHandler& on_item);
+
+Document LoadFileParallel(const std::string& path, const std::string& split_key, size_t range_count,
+                          const RangeItemHandler& on_item);
+
 struct PrintContext {
     std::ostream& out;
     int indent_step = 4;
     int indent = 0;
+    // Вывод в одну строку: без переводов строк и отступов
+    bool compact = false;
 
     void PrintIndent() const {
+        if (compact) {
+            return;
+        }
         for (int i = 0; i < indent; ++i) {
             out.put(' ');
         }
     }
 
+    void PrintLineBreak() const {
+        if (!compact) {
+            out.put('\n');
+        }
+    }
+
+    // Разделитель ключа и значения словаря
+    std::string_view KeySeparator() const {
+        return compact ? ":" : ": ";
+    }
+
     // Возвращает новый контекст вывода с увеличенным смещением
     PrintContext Indented(int offset = 0) const {
-        return {out, indent_step, indent_step + indent + offset};
+        return {out, indent_step, indent_step + indent + offset, compact};
     }
 };
 
 namespace detail {
 
-// Шаблон, подходящий для вывода double и int
-template<typename T>
-void PrintValue(const T& value, const PrintContext& ctx) {
-    auto& out = ctx.out;
-    out << value;
-}
+void PrintValue(int value, const PrintContext& ctx);
+
+void PrintValue(double value, const PrintContext& ctx);
 
 void PrintNode(const Node& node, const PrintContext& ctx);
 
@@ -4,6 +4,9 @@ namespace json {
 
 using namespace std::literals;
 
+Builder::Builder(std::pmr::memory_resource* resource) : resource_(resource) {
+}
+
 Builder::DictValueContext Builder::Key(std::string key) {
     if (root_.IsNull() || (!nodes_stack_.empty() && !nodes_stack_.back()->IsDict())) {
         throw std::logic_error("Incorrect Dict key insertion"s);
@@ -87,7 +90,8 @@ json::Node Builder::Build() {
     if (!nodes_stack_.empty()) {
         throw std::logic_error("Cannot build incomplete sequence"s);
     }
-    return root_;
+    // Дерево перемещается из строителя, чтобы не копировать его из арены в общую кучу
+    return std::move(root_);
 }
 
 bool Builder::IsSingleValueRoot() {
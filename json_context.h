@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+
+#include "json.h"
+
+namespace json {
+
+namespace detail {
+
+template <typename Owner>
+class DictValueContext;
+
+template <typename Owner>
+class DictItemContext;
+
+template <typename Owner>
+class ArrayItemContext;
+
+// Контексты цепочки вызовов Key/Value/Start*/End*, общие для json::Builder и json::Writer.
+// Каждый контекст удаляет методы, недопустимые в текущей позиции, так что ошибка видна при компиляции
+template <typename Owner>
+class BaseContext {
+public:
+    explicit BaseContext(Owner& owner) : owner_(owner) {
+    }
+
+    DictValueContext<Owner> Key(std::string key) {
+        return owner_.Key(std::move(key));
+    }
+
+    BaseContext Value(json::Value value) {
+        return owner_.Value(std::move(value));
+    }
+
+    DictItemContext<Owner> StartDict() {
+        return owner_.StartDict();
+    }
+
+    ArrayItemContext<Owner> StartArray() {
+        return owner_.StartArray();
+    }
+
+    BaseContext EndDict() {
+        return owner_.EndDict();
+    }
+
+    BaseContext EndArray() {
+        return owner_.EndArray();
+    }
+
+    json::Node Build() {
+        return owner_.Build();
+    }
+
+    Owner& GetOwner() const {
+        return owner_;
+    }
+
+private:
+    Owner& owner_;
+};
+
+template <typename Owner>
+class DictItemContext final : public BaseContext<Owner> {
+public:
+    DictItemContext(BaseContext<Owner> context) : BaseContext<Owner>(context.GetOwner()) {
+    }
+
+    BaseContext<Owner> Value(json::Value) = delete;
+
+    DictItemContext StartDict() = delete;
+
+    ArrayItemContext<Owner> StartArray() = delete;
+
+    BaseContext<Owner> EndArray() = delete;
+
+    json::Node Build() = delete;
+};
+
+template <typename Owner>
+class DictValueContext final : public BaseContext<Owner> {
+public:
+    DictValueContext(BaseContext<Owner> context) : BaseContext<Owner>(context.GetOwner()) {
+    }
+
+    DictValueContext Key(std::string) = delete;
+
+    BaseContext<Owner> EndDict() = delete;
+
+    BaseContext<Owner> EndArray() = delete;
+
+    json::Node Build() = delete;
+
+    DictItemContext<Owner> Value(json::Value value) {
+        return BaseContext<Owner>::Value(std::move(value));
+    }
+};
+
+template <typename Owner>
+class ArrayItemContext final : public BaseContext<Owner> {
+public:
+    ArrayItemContext(BaseContext<Owner> context) : BaseContext<Owner>(context.GetOwner()) {
+    }
+
+    DictValueContext<Owner> Key(std::string) = delete;
+
+    BaseContext<Owner> EndDict() = delete;
+
+    json::Node Build() = delete;
+
+    ArrayItemContext Value(json::Value value) {
+        return BaseContext<Owner>::Value(std::move(value));
+    }
+};
+
+}  // namespace detail
+
+}  // namespace json
@@ -1,5 +1,17 @@
 #include "json_reader.h"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "json_schema.h"
+#include "parallel.h"
+
 namespace json_reader {
 
 JsonReader::JsonReader(json::Document document) : raw_document_(std::move(document)) {}
@@ -12,8 +24,7 @@ const std::vector<transport_routine::request_handler::BusBaseRequest>& JsonReade
     return bus_base_requests_;
 }
 
-const std::vector<std::unique_ptr<transport_routine::request_handler::StatRequest>>& JsonReader::GetStatRequests()
-    const {
+const std::vector<transport_routine::request_handler::StatRequest>& JsonReader::GetStatRequests() const {
     return stat_requests_;
 }
 
@@ -37,97 +48,34 @@ void JsonReader::ProcessDocumentRequestLoad() {
     ProcessSerializationSettings();
 }
 
+// Строки запросов перемещаются из документа, после разбора base_requests остаётся пустым
 void JsonReader::ProcessBaseRequests() {
     using namespace std::literals;
-    const json::Array raw_requests = raw_document_.GetRoot().AsDict().at("base_requests"s).AsArray();
-    json::Array stop_raw_requests;
-    json::Array bus_raw_requests;
-
-    if (raw_requests.empty()) {
-        return;
-    }
-
-    for (const json::Node& raw_request : raw_requests) {
-        if (raw_request.AsDict().at("type"s) == "Stop"s) {
-            stop_raw_requests.push_back(raw_request);
-        } else if (raw_request.AsDict().at("type"s) == "Bus"s) {
-            bus_raw_requests.push_back(raw_request);
+    json::Array& raw_requests = raw_document_.GetRoot().AsDict().at("base_requests"s).AsArray();
+
+    for (json::Node& raw_request : raw_requests) {
+        const std::string& type = raw_request.AsDict().at("type"sv).AsString();
+        if (type == "Stop"sv) {
+            stop_base_requests_.push_back(detail::ParseStopRequest(raw_request));
+        } else if (type == "Bus"sv) {
+            bus_base_requests_.push_back(detail::ParseBusRequest(raw_request));
         }
     }
-
-    if (!stop_raw_requests.empty()) {
-        ProcessStopRequests(stop_raw_requests);
-    }
-    if (!bus_raw_requests.empty()) {
-        ProcessBusRequests(bus_raw_requests);
-    }
+    raw_requests.clear();
 }
 
 void JsonReader::ProcessStatRequests() {
     using namespace std::literals;
 
-    const json::Array raw_requests = raw_document_.GetRoot().AsDict().at("stat_requests"s).AsArray();
-
-    if (raw_requests.empty()) {
+    json::Dict& root = raw_document_.GetRoot().AsDict();
+    if (root.count("stat_requests"sv) == 0) {
         return;
     }
-
-    for (const json::Node& stat_request : raw_requests) {
-        const std::string type = stat_request.AsDict().at("type"s).AsString();
-        const int id = stat_request.AsDict().at("id"s).AsInt();
-        if (type == "Map"s) {
-            stat_requests_.push_back(std::make_unique<transport_routine::request_handler::MapRequest>(id, type));
-            continue;
-        } else if (type == "Route"s) {
-            const std::string from = stat_request.AsDict().at("from"s).AsString();
-            const std::string to = stat_request.AsDict().at("to"s).AsString();
-            stat_requests_.push_back(
-                std::make_unique<transport_routine::request_handler::RouteRequest>(id, type, from, to));
-            continue;
-        }
-        const std::string name = stat_request.AsDict().at("name"s).AsString();
-        if (type == "Stop"s || type == "Bus"s) {
-            stat_requests_.push_back(
-                std::make_unique<transport_routine::request_handler::BusStopStatRequest>(id, type, name));
-        }
-    }
-}
-
-void JsonReader::ProcessStopRequests(const json::Array& stop_raw_requests) {
-    using namespace std::literals;
-    std::vector<transport_routine::request_handler::StopBaseRequest> ret;
-
-    for (const json::Node& stop_raw_request : stop_raw_requests) {
-        transport_routine::request_handler::StopBaseRequest request;
-        request.name = stop_raw_request.AsDict().at("name"s).AsString();
-        request.coordinates = {stop_raw_request.AsDict().at("latitude"s).AsDouble(),
-                               stop_raw_request.AsDict().at("longitude"s).AsDouble()};
-        const json::Dict stops_to_distances = stop_raw_request.AsDict().at("road_distances"s).AsDict();
-        for (const std::pair<std::string, json::Node> value : stops_to_distances) {
-            request.distances_to.emplace(make_pair(value.first, value.second.AsInt()));
+    for (json::Node& stat_request : root.at("stat_requests"sv).AsArray()) {
+        if (auto request = detail::ParseStatRequest(stat_request)) {
+            stat_requests_.push_back(std::move(*request));
         }
-        ret.emplace_back(request);
     }
-
-    stop_base_requests_ = std::move(ret);
-}
-
-void JsonReader::ProcessBusRequests(const json::Array& bus_raw_requests) {
-    using namespace std::literals;
-    std::vector<transport_routine::request_handler::BusBaseRequest> ret;
-
-    for (const json::Node& bus_raw_request : bus_raw_requests) {
-        transport_routine::request_handler::BusBaseRequest request;
-        request.name = bus_raw_request.AsDict().at("name"s).AsString();
-        const json::Array stops = bus_raw_request.AsDict().at("stops"s).AsArray();
-        for (const json::Node& stop : stops) {
-            request.route.emplace_back(stop.AsString());
-        }
-        request.is_roundtrip = bus_raw_request.AsDict().at("is_roundtrip"s).AsBool();
-        ret.emplace_back(request);
-    }
-
-    bus_base_requests_ = std::move(ret);
 }
 
 void JsonReader::ProcessRenderSettings() {
@@ -135,7 +83,7 @@ void JsonReader::ProcessRenderSettings() {
     if (raw_document_.GetRoot().AsDict().count("render_settings"s) == 0) {
         return;
     }
-    json::Dict raw_render_settings = raw_document_.GetRoot().AsDict().at("render_settings"s).AsDict();
+    const json::Dict& raw_render_settings = raw_document_.GetRoot().AsDict().at("render_settings"s).AsDict();
     if (raw_render_settings.empty()) {
         return;
     }
@@ -150,13 +98,11 @@ void JsonReader::ProcessRenderSettings() {
     render_settings_.stop_label_font_size = raw_render_settings.at("stop_label_font_size"s).AsInt();
     render_settings_.stop_label_offset = {raw_render_settings.at("stop_label_offset"s).AsArray()[0].AsDouble(),
                                           raw_render_settings.at("stop_label_offset"s).AsArray()[1].AsDouble()};
-    auto raw_color = raw_render_settings.at("underlayer_color"s).GetValue();
-    render_settings_.underlayer_color = std::visit(detail::ColorReader{}, raw_color);
+    render_settings_.underlayer_color =
+        std::visit(detail::ColorReader{}, raw_render_settings.at("underlayer_color"s).GetValue());
     render_settings_.underlayer_width = raw_render_settings.at("underlayer_width"s).AsDouble();
-    json::Array raw_palette = raw_render_settings.at("color_palette"s).AsArray();
-    for (const json::Node& color_node : raw_palette) {
-        auto color = color_node.GetValue();
-        render_settings_.color_palette.push_back(std::visit(detail::ColorReader{}, color));
+    for (const json::Node& color_node : raw_render_settings.at("color_palette"s).AsArray()) {
+        render_settings_.color_palette.push_back(std::visit(detail::ColorReader{}, color_node.GetValue()));
     }
 }
 
@@ -165,7 +111,7 @@ void JsonReader::ProcessRoutingSettings() {
     if (raw_document_.GetRoot().AsDict().count("routing_settings"s) == 0) {
         return;
     }
-    json::Dict raw_routing_settings = raw_document_.GetRoot().AsDict().at("routing_settings"s).AsDict();
+    const json::Dict& raw_routing_settings = raw_document_.GetRoot().AsDict().at("routing_settings"s).AsDict();
     if (raw_routing_settings.empty()) {
         return;
     }
@@ -175,7 +121,8 @@ void JsonReader::ProcessRoutingSettings() {
 
 void JsonReader::ProcessSerializationSettings() {
     using namespace std::literals;
-    json::Dict raw_serialization_settings = raw_document_.GetRoot().AsDict().at("serialization_settings"s).AsDict();
+    const json::Dict& raw_serialization_settings =
+        raw_document_.GetRoot().AsDict().at("serialization_settings"s).AsDict();
     if (raw_serialization_settings.empty()) {
         return;
     }
@@ -184,6 +131,20 @@ void JsonReader::ProcessSerializationSettings() {
 
 namespace detail {
 
+json::Dict MemoryReportToJSON(const memory_usage::MemoryReport& report) {
+    using namespace std::literals;
+    const auto bytes_to_node = [](size_t bytes) {
+        return bytes <= static_cast<size_t>(std::numeric_limits<int>::max()) ? json::Node(static_cast<int>(bytes))
+                                                                            : json::Node(static_cast<double>(bytes));
+    };
+    json::Dict ret;
+    for (const auto& [name, bytes] : report.items) {
+        ret[name] = bytes_to_node(bytes);
+    }
+    ret["total"s] = bytes_to_node(report.Total());
+    return ret;
+}
+
 svg::Color ColorReader::operator()(const json::Array& arr) const {
     if (arr.size() == 3) {
         return svg::Rgb(arr[0].AsInt(), arr[1].AsInt(), arr[2].AsInt());
@@ -197,6 +158,220 @@ svg::Color ColorReader::operator()(const std::string& str) const { return str; }
 
 svg::Color ColorReader::operator()(...) const { return {}; }
 
+namespace {
+
+using namespace std::literals;
+
+constexpr auto STOP_REQUEST_SCHEMA = std::make_tuple(
+    json::schema::Required("name"sv, &transport_routine::request_handler::StopBaseRequest::name),
+    json::schema::Required("latitude"sv,
+                           [](transport_routine::request_handler::StopBaseRequest& out, const json::Node& value) {
+                               out.coordinates.lat = value.AsDouble();
+                           }),
+    json::schema::Required("longitude"sv,
+                           [](transport_routine::request_handler::StopBaseRequest& out, const json::Node& value) {
+                               out.coordinates.lng = value.AsDouble();
+                           }),
+    json::schema::Required("road_distances"sv, &transport_routine::request_handler::StopBaseRequest::distances_to));
+
+constexpr auto BUS_REQUEST_SCHEMA = std::make_tuple(
+    json::schema::Required("name"sv, &transport_routine::request_handler::BusBaseRequest::name),
+    json::schema::Required("stops"sv, &transport_routine::request_handler::BusBaseRequest::route),
+    json::schema::Required("is_roundtrip"sv, &transport_routine::request_handler::BusBaseRequest::is_roundtrip));
+
+// Схемы запросов stat_requests: поля каждого запроса читаются прямо в его структуру
+template <typename Request>
+constexpr auto ID_FIELD = json::schema::Required("id"sv, &Request::id);
+
+constexpr auto STOP_STAT_SCHEMA =
+    std::make_tuple(ID_FIELD<transport_routine::request_handler::StopStatRequest>,
+                    json::schema::Required("name"sv, &transport_routine::request_handler::StopStatRequest::name));
+constexpr auto BUS_STAT_SCHEMA =
+    std::make_tuple(ID_FIELD<transport_routine::request_handler::BusStatRequest>,
+                    json::schema::Required("name"sv, &transport_routine::request_handler::BusStatRequest::name));
+constexpr auto MAP_SCHEMA = std::make_tuple(ID_FIELD<transport_routine::request_handler::MapRequest>);
+constexpr auto STATS_SCHEMA = std::make_tuple(ID_FIELD<transport_routine::request_handler::StatsRequest>);
+constexpr auto ROUTE_SCHEMA =
+    std::make_tuple(ID_FIELD<transport_routine::request_handler::RouteRequest>,
+                    json::schema::Required("from"sv, &transport_routine::request_handler::RouteRequest::from),
+                    json::schema::Required("to"sv, &transport_routine::request_handler::RouteRequest::to));
+constexpr auto ISOCHRONE_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::IsochroneRequest>,
+    json::schema::Required("from"sv, &transport_routine::request_handler::IsochroneRequest::from),
+    json::schema::Required("max_time"sv, &transport_routine::request_handler::IsochroneRequest::max_time));
+constexpr auto MATRIX_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::MatrixRequest>,
+    json::schema::Required("origins"sv, &transport_routine::request_handler::MatrixRequest::origins),
+    json::schema::Required("destinations"sv, &transport_routine::request_handler::MatrixRequest::destinations));
+constexpr auto SUGGEST_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::SuggestRequest>,
+    json::schema::Required("prefix"sv, &transport_routine::request_handler::SuggestRequest::prefix),
+    json::schema::Required("limit"sv,
+                           [](transport_routine::request_handler::SuggestRequest& out, const json::Node& value) {
+                               out.limit = static_cast<size_t>(std::max(value.AsInt(), 0));
+                           }));
+constexpr auto COMMON_BUSES_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::CommonBusesRequest>,
+    json::schema::Required("stops"sv, &transport_routine::request_handler::CommonBusesRequest::stops));
+constexpr auto STOPS_OF_BUSES_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::StopsOfBusesRequest>,
+    json::schema::Required("buses"sv, &transport_routine::request_handler::StopsOfBusesRequest::buses));
+constexpr auto NEARBY_STOPS_SCHEMA = std::make_tuple(
+    ID_FIELD<transport_routine::request_handler::NearbyStopsRequest>,
+    json::schema::Required("latitude"sv,
+                           [](transport_routine::request_handler::NearbyStopsRequest& out, const json::Node& value) {
+                               out.point.lat = value.AsDouble();
+                           }),
+    json::schema::Required("longitude"sv,
+                           [](transport_routine::request_handler::NearbyStopsRequest& out, const json::Node& value) {
+                               out.point.lng = value.AsDouble();
+                           }),
+    json::schema::Optional("radius"sv, &transport_routine::request_handler::NearbyStopsRequest::radius),
+    json::schema::Optional("count"sv,
+                           [](transport_routine::request_handler::NearbyStopsRequest& out, const json::Node& value) {
+                               // count 0 означает "без ограничения", поэтому отрицательное значение — ошибка
+                               const int count = value.AsInt();
+                               if (count < 0) {
+                                   throw std::invalid_argument("NearbyStops count must be non-negative"s);
+                               }
+                               out.count = static_cast<size_t>(count);
+                           }));
+
+template <typename Request, const auto& Schema>
+transport_routine::request_handler::StatRequest ParseTypedStatRequest(json::Dict& raw_request) {
+    Request request;
+    json::schema::Extract(raw_request, request, Schema);
+    return request;
+}
+
+// Без radius и count запрос не ограничен, поэтому одно из них обязательно. Без radius расстояние не ограничено
+transport_routine::request_handler::StatRequest ParseNearbyStopsRequest(json::Dict& raw_request) {
+    if (raw_request.count("radius"sv) == 0 && raw_request.count("count"sv) == 0) {
+        throw std::invalid_argument("NearbyStops request requires radius or count"s);
+    }
+    transport_routine::request_handler::NearbyStopsRequest request;
+    request.radius = std::numeric_limits<double>::infinity();
+    json::schema::Extract(raw_request, request, NEARBY_STOPS_SCHEMA);
+    return request;
+}
+
+using StatRequestParse = transport_routine::request_handler::StatRequest (*)(json::Dict& raw_request);
+
+struct StatRequestParser {
+    std::string_view type;
+    uint64_t hash = 0;
+    StatRequestParse parse = nullptr;
+};
+
+constexpr StatRequestParser MakeStatRequestParser(std::string_view type, StatRequestParse parse) {
+    return {type, json::schema::HashKey(type), parse};
+}
+
+// Тип запроса сравнивается с таблицей по хешу, посчитанному при компиляции, и только при совпадении — по строке
+constexpr StatRequestParser STAT_REQUEST_PARSERS[] = {
+    MakeStatRequestParser(
+        "Stop"sv, ParseTypedStatRequest<transport_routine::request_handler::StopStatRequest, STOP_STAT_SCHEMA>),
+    MakeStatRequestParser(
+        "Bus"sv, ParseTypedStatRequest<transport_routine::request_handler::BusStatRequest, BUS_STAT_SCHEMA>),
+    MakeStatRequestParser("Map"sv, ParseTypedStatRequest<transport_routine::request_handler::MapRequest, MAP_SCHEMA>),
+    MakeStatRequestParser("Stats"sv,
+                          ParseTypedStatRequest<transport_routine::request_handler::StatsRequest, STATS_SCHEMA>),
+    MakeStatRequestParser("Route"sv,
+                          ParseTypedStatRequest<transport_routine::request_handler::RouteRequest, ROUTE_SCHEMA>),
+    MakeStatRequestParser(
+        "Isochrone"sv,
+        ParseTypedStatRequest<transport_routine::request_handler::IsochroneRequest, ISOCHRONE_SCHEMA>),
+    MakeStatRequestParser("Matrix"sv,
+                          ParseTypedStatRequest<transport_routine::request_handler::MatrixRequest, MATRIX_SCHEMA>),
+    MakeStatRequestParser(
+        "Suggest"sv, ParseTypedStatRequest<transport_routine::request_handler::SuggestRequest, SUGGEST_SCHEMA>),
+    MakeStatRequestParser(
+        "CommonBuses"sv,
+        ParseTypedStatRequest<transport_routine::request_handler::CommonBusesRequest, COMMON_BUSES_SCHEMA>),
+    MakeStatRequestParser(
+        "StopsOfBuses"sv,
+        ParseTypedStatRequest<transport_routine::request_handler::StopsOfBusesRequest, STOPS_OF_BUSES_SCHEMA>),
+    MakeStatRequestParser("NearbyStops"sv, ParseNearbyStopsRequest),
+};
+
+}  // namespace
+
+transport_routine::request_handler::StopBaseRequest ParseStopRequest(json::Node& stop_raw_request) {
+    transport_routine::request_handler::StopBaseRequest request;
+    json::schema::Extract(stop_raw_request.AsDict(), request, STOP_REQUEST_SCHEMA);
+    return request;
+}
+
+transport_routine::request_handler::BusBaseRequest ParseBusRequest(json::Node& bus_raw_request) {
+    transport_routine::request_handler::BusBaseRequest request;
+    json::schema::Extract(bus_raw_request.AsDict(), request, BUS_REQUEST_SCHEMA);
+    return request;
+}
+
+std::optional<transport_routine::request_handler::StatRequest> ParseStatRequest(json::Node& stat_request) {
+    json::Dict& raw_request = stat_request.AsDict();
+    const std::string& type = raw_request.at("type"sv).AsString();
+    const uint64_t hash = json::schema::HashKey(type);
+    for (const StatRequestParser& parser : STAT_REQUEST_PARSERS) {
+        if (parser.hash == hash && parser.type == type) {
+            return parser.parse(raw_request);
+        }
+    }
+    return std::nullopt;
+}
+
+BaseStreamLoader::BaseStreamLoader(transport_routine::request_handler::RequestHandler& handler)
+    : handler_(handler) {}
+
+void BaseStreamLoader::AddRequest(json::Node raw_request) {
+    using namespace std::literals;
+    const std::string& type = raw_request.AsDict().at("type"sv).AsString();
+    if (type == "Stop"sv) {
+        transport_routine::request_handler::StopBaseRequest request = ParseStopRequest(raw_request);
+        handler_.AddStop(request);
+        for (const auto& [dest, distance] : request.distances_to) {
+            distances_.push_back({request.name, dest, distance});
+        }
+    } else if (type == "Bus"sv) {
+        transport_routine::request_handler::BusBaseRequest request = ParseBusRequest(raw_request);
+        const transport_routine::catalogue::TransportCatalogue& catalogue = handler_.GetCatalogue();
+        const bool stops_known =
+            std::all_of(request.route.begin(), request.route.end(),
+                        [&catalogue](const std::string& stop) { return catalogue.FindStop(stop) != nullptr; });
+        if (buses_.empty() && stops_known) {
+            StartBulkLoad();
+            handler_.AddBus(request);
+        } else {
+            buses_.push_back(std::move(request));
+        }
+    }
+}
+
+void BaseStreamLoader::Finish() {
+    for (const DeferredDistance& distance : distances_) {
+        handler_.SetDistance(distance.from, distance.to, distance.distance);
+    }
+    distances_.clear();
+    if (!buses_.empty()) {
+        StartBulkLoad();
+        for (const auto& bus_base_request : buses_) {
+            handler_.AddBus(bus_base_request);
+        }
+        buses_.clear();
+    }
+    if (is_bulk_load_) {
+        handler_.EndBulkLoad();
+        is_bulk_load_ = false;
+    }
+}
+
+void BaseStreamLoader::StartBulkLoad() {
+    if (!is_bulk_load_) {
+        handler_.BeginBulkLoad();
+        is_bulk_load_ = true;
+    }
+}
+
 void AddBase(const std::vector<transport_routine::request_handler::StopBaseRequest>& stop_base_requests,
              const std::vector<transport_routine::request_handler::BusBaseRequest>& bus_base_requests,
              transport_routine::request_handler::RequestHandler& handler) {
@@ -214,9 +389,11 @@ void AddBase(const std::vector<transport_routine::request_handler::StopBaseReque
         }
     }
     if (!bus_base_requests.empty()) {
+        handler.BeginBulkLoad();
         for (const auto& bus_base_request : bus_base_requests) {
             handler.AddBus(bus_base_request);
         }
+        handler.EndBulkLoad();
     }
 }
 
@@ -225,87 +402,260 @@ void AddBaseFromReader(const json_reader::JsonReader& reader,
     AddBase(reader.GetStopRequests(), reader.GetBusRequests(), handler);
 }
 
-}  // namespace detail
+namespace {
 
-json::Document ProcessStatRequestToJSON(const JsonReader& document,
-                                        transport_routine::request_handler::RequestHandler& handler) {
+// Тело ответа на запрос к базе, без request_id
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::StopStatRequest&,
+                       const transport_routine::request_handler::StopStatRequest::Response& buses,
+                       const transport_routine::request_handler::RequestHandler&) {
     using namespace std::literals;
-    json::Builder builder{};
-    builder.StartArray();
-
-    for (const auto& request : document.GetStatRequests()) {
-        json::Builder stat_dict{};
-        stat_dict.StartDict();
-        stat_dict.Key("request_id"s).Value(request->GetId());
-        if (request->GetType() == "Stop"s) {
-            auto stat_request = dynamic_cast<transport_routine::request_handler::BusStopStatRequest*>(request.get());
-            if (const std::set<std::string_view>* stops = handler.GetBusesByStop(stat_request->GetName())) {
-                json::Array buses;
-                if (!stops->empty()) {
-                    for (std::string_view bus : *stops) {
-                        buses.emplace_back(std::string(bus));
-                    }
-                }
-                stat_dict.Key("buses"s).Value(buses);
+    if (!buses) {
+        writer.Key("error_message"s).Value("not found"s);
+        return;
+    }
+    writer.Key("buses"s).StartArray();
+    for (std::string_view bus : *buses) {
+        writer.Value(std::string(bus));
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::BusStatRequest&,
+                       const transport_routine::request_handler::BusStatRequest::Response& bus_stats,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    if (!bus_stats) {
+        writer.Key("error_message"s).Value("not found"s);
+        return;
+    }
+    writer.Key("route_length"s)
+        .Value(bus_stats->total_distance)
+        .Key("stop_count"s)
+        .Value(bus_stats->total_stops)
+        .Key("unique_stop_count"s)
+        .Value(bus_stats->unique_stops)
+        .Key("curvature"s)
+        .Value(bus_stats->curvature);
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::MapRequest&,
+                       const transport_routine::request_handler::MapRequest::Response& map,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    std::ostringstream ostr;
+    map.Render(ostr);
+    writer.Key("map"s).Value(ostr.str());
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::StatsRequest&,
+                       const transport_routine::request_handler::StatsRequest::Response& stats,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    writer.Key("catalogue"s).Value(MemoryReportToJSON(stats.catalogue));
+    writer.Key("router"s).Value(MemoryReportToJSON(stats.router));
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::RouteRequest&,
+                       const transport_routine::request_handler::RouteRequest::Response& route,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    if (!route) {
+        writer.Key("error_message"s).Value("not found"s);
+        return;
+    }
+    writer.Key("total_time"s).Value(route.total_time);
+    writer.Key("items"s).StartArray();
+    for (const transport_router::RouteItem& item : route.items) {
+        writer.StartDict();
+        if (item.type == transport_router::RouteItemType::WAIT) {
+            writer.Key("type"s).Value("Wait"s).Key("stop_name"s).Value(item.name).Key("time"s).Value(item.time);
+        } else if (item.type == transport_router::RouteItemType::BUS) {
+            writer.Key("type"s)
+                .Value("Bus"s)
+                .Key("bus"s)
+                .Value(item.name)
+                .Key("span_count"s)
+                .Value(static_cast<int>(item.span_count))
+                .Key("time"s)
+                .Value(item.time);
+        }
+        writer.EndDict();
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::NearbyStopsRequest&,
+                       const transport_routine::request_handler::NearbyStopsRequest::Response& neighbours,
+                       const transport_routine::request_handler::RequestHandler& handler) {
+    using namespace std::literals;
+    const transport_routine::catalogue::TransportCatalogue& catalogue = handler.GetCatalogue();
+    writer.Key("stops"s).StartArray();
+    for (const spatial_index::Neighbour& neighbour : neighbours) {
+        writer.StartDict()
+            .Key("name"s)
+            .Value(catalogue.GetStop(neighbour.id).name)
+            .Key("distance"s)
+            .Value(neighbour.distance)
+            .EndDict();
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::IsochroneRequest&,
+                       const transport_routine::request_handler::IsochroneRequest::Response& reachable_stops,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    if (!reachable_stops) {
+        writer.Key("error_message"s).Value("not found"s);
+        return;
+    }
+    writer.Key("stops"s).StartArray();
+    for (const transport_router::ReachableStop& stop : *reachable_stops) {
+        writer.StartDict().Key("stop_name"s).Value(std::string(stop.name)).Key("time"s).Value(stop.time).EndDict();
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::MatrixRequest&,
+                       const transport_routine::request_handler::MatrixRequest::Response& total_times,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    writer.Key("total_times"s).StartArray();
+    for (const auto& row : total_times) {
+        writer.StartArray();
+        for (const std::optional<double>& time : row) {
+            if (time) {
+                writer.Value(*time);
             } else {
-                stat_dict.Key("error_message"s).Value("not found"s);
+                writer.Value(nullptr);
             }
-        } else if (request->GetType() == "Bus"s) {
-            auto stat_request = dynamic_cast<transport_routine::request_handler::BusStopStatRequest*>(request.get());
-            if (const transport_routine::domain::RouteStats* bus_stats = handler.GetBusStat(stat_request->GetName())) {
-                stat_dict.Key("route_length"s)
-                    .Value(bus_stats->total_distance)
-                    .Key("stop_count"s)
-                    .Value(bus_stats->total_stops)
-                    .Key("unique_stop_count"s)
-                    .Value(bus_stats->unique_stops)
-                    .Key("curvature"s)
-                    .Value(bus_stats->curvature);
-            } else {
-                stat_dict.Key("error_message"s).Value("not found"s);
+        }
+        writer.EndArray();
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::SuggestRequest&,
+                       const transport_routine::request_handler::SuggestRequest::Response& suggestions,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    writer.Key("stops"s).StartArray();
+    for (std::string_view stop : suggestions.stops) {
+        writer.Value(std::string(stop));
+    }
+    writer.EndArray().Key("buses"s).StartArray();
+    for (std::string_view bus : suggestions.buses) {
+        writer.Value(std::string(bus));
+    }
+    writer.EndArray();
+}
+
+void WriteNameList(json::Writer& writer, const std::string& key,
+                   const std::optional<std::vector<std::string_view>>& names) {
+    using namespace std::literals;
+    if (!names) {
+        writer.Key("error_message"s).Value("not found"s);
+        return;
+    }
+    writer.Key(key).StartArray();
+    for (std::string_view name : *names) {
+        writer.Value(std::string(name));
+    }
+    writer.EndArray();
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::CommonBusesRequest&,
+                       const transport_routine::request_handler::CommonBusesRequest::Response& buses,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    WriteNameList(writer, "buses"s, buses);
+}
+
+void WriteResponseBody(json::Writer& writer, const transport_routine::request_handler::StopsOfBusesRequest&,
+                       const transport_routine::request_handler::StopsOfBusesRequest::Response& stops,
+                       const transport_routine::request_handler::RequestHandler&) {
+    using namespace std::literals;
+    WriteNameList(writer, "stops"s, stops);
+}
+
+}  // namespace
+
+template <typename Request>
+void WriteStatResponse(json::Writer& writer, const Request& request, const typename Request::Response& response,
+                       const transport_routine::request_handler::RequestHandler& handler) {
+    using namespace std::literals;
+    writer.StartDict();
+    writer.Key("request_id"s).Value(request.id);
+    WriteResponseBody(writer, request, response, handler);
+    writer.EndDict();
+}
+
+std::unique_ptr<transport_routine::snapshot::Snapshot> LoadSnapshot(
+    const serialization::SerializationSettings& settings) {
+    auto snapshot = std::make_unique<transport_routine::snapshot::Snapshot>();
+    serialization::DeserializeCatalogue(snapshot->handler, settings);
+    return snapshot;
+}
+
+void WriteStatResponse(json::Writer& writer, const transport_routine::request_handler::StatRequest& request,
+                       const transport_routine::request_handler::RequestHandler& handler) {
+    std::visit(
+        [&writer, &handler](const auto& typed_request) {
+            WriteStatResponse(writer, typed_request, handler.Execute(typed_request), handler);
+        },
+        request);
+}
+
+}  // namespace detail
+
+void ProcessStatRequestToJSON(const JsonReader& document,
+                              const transport_routine::request_handler::RequestHandler& handler, std::ostream& output) {
+    static const size_t WINDOW_SIZE = 4096;
+    static const size_t MIN_REQUESTS_PER_THREAD = 32;
+    const std::vector<transport_routine::request_handler::StatRequest>& requests = document.GetStatRequests();
+    json::Writer writer(output);
+    writer.StartArray();
+    // На одном ядре или для небольшого числа запросов ответы записываются сразу, без промежуточных буферов
+    if (std::thread::hardware_concurrency() <= 1 || requests.size() < 2 * MIN_REQUESTS_PER_THREAD) {
+        handler.ExecuteStatRequests(requests, [&writer, &handler](const auto& request, const auto& response) {
+            detail::WriteStatResponse(writer, request, response, handler);
+        });
+        writer.EndArray();
+        return;
+    }
+
+    // Запросы выполняются окнами: запросы окна делятся между потоками, каждый поток записывает ответы
+    // в свой буфер так же, как они выглядят внутри массива ответов, затем ответы выводятся по порядку.
+    // Окно ограничивает память под готовые ответы
+    std::vector<std::string> responses;
+    std::vector<std::exception_ptr> errors;
+    for (size_t window_first = 0; window_first < requests.size(); window_first += WINDOW_SIZE) {
+        const size_t window_last = std::min(window_first + WINDOW_SIZE, requests.size());
+        responses.assign(window_last - window_first, {});
+        errors.assign(window_last - window_first, nullptr);
+        parallel::ForEachRange(window_first, window_last, MIN_REQUESTS_PER_THREAD, [&](size_t first, size_t last) {
+            std::ostringstream buffer;
+            size_t i = first;
+            try {
+                handler.ExecuteStatRequests(requests, first, last, [&](const auto& request, const auto& response) {
+                    json::Writer response_writer(buffer, false, 1);
+                    detail::WriteStatResponse(response_writer, request, response, handler);
+                    responses[i++ - window_first] = buffer.str();
+                    buffer.str({});
+                });
+            } catch (...) {
+                errors[i - window_first] = std::current_exception();
             }
-        } else if (request->GetType() == "Map"s) {
-            std::ostringstream ostr;
-            handler.RenderRouteMap().Render(ostr);
-            stat_dict.Key("map"s).Value(ostr.str());
-        } else if (request->GetType() == "Route"s) {
-            auto stat_request = dynamic_cast<transport_routine::request_handler::RouteRequest*>(request.get());
-            transport_router::Route route = handler.GetRoute(stat_request->GetFrom(), stat_request->GetTo());
-            if (!route) {
-                stat_dict.Key("error_message"s).Value("not found"s);
-            } else {
-                stat_dict.Key("total_time"s).Value(route.total_time);
-                stat_dict.Key("items"s).StartArray();
-                for (const transport_router::RouteItem& item : route.items) {
-                    stat_dict.StartDict();
-                    if (item.type == transport_router::RouteItemType::WAIT) {
-                        stat_dict.Key("type"s)
-                            .Value("Wait"s)
-                            .Key("stop_name"s)
-                            .Value(item.name)
-                            .Key("time"s)
-                            .Value(item.time);
-                    } else if (item.type == transport_router::RouteItemType::BUS) {
-                        stat_dict.Key("type"s)
-                            .Value("Bus"s)
-                            .Key("bus"s)
-                            .Value(item.name)
-                            .Key("span_count"s)
-                            .Value(static_cast<int>(item.span_count))
-                            .Key("time"s)
-                            .Value(item.time);
-                    }
-                    stat_dict.EndDict();
-                }
-                stat_dict.EndArray();
+        });
+        // Ошибка выбрасывается на том же запросе, что и при последовательном выполнении
+        for (size_t i = 0; i < responses.size(); ++i) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
             }
+            writer.RawValue(responses[i]);
         }
-        stat_dict.EndDict();
-        builder.Value(stat_dict.Build().AsDict());
     }
-
-    builder.EndArray();
-    return json::Document{builder.Build()};
+    writer.EndArray();
 }
 
 void ProcessJsonRequest(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
@@ -316,6 +666,9 @@ void ProcessJsonRequest(transport_routine::request_handler::RequestHandler& hand
     document.ProcessDocumentRequestLoad();
     handler.SetRenderSettings(document.GetRenderSettings());
     detail::AddBaseFromReader(document, handler);
+    handler.BuildPrefixIndex();
+    handler.BuildSpatialIndex();
+    handler.BuildMembershipIndex();
     std::unique_ptr<transport_router::TransportRouter> t_router =
         transport_router::TransportRouter::TransportRouterBuilder(handler.GetCatalogue(), document.GetRoutingSettings())
             .Build();
@@ -325,15 +678,21 @@ void ProcessJsonRequest(transport_routine::request_handler::RequestHandler& hand
         return;
     }
 
-    json::Document result = ProcessStatRequestToJSON(document, handler);
-    json::Print(result, output);
+    ProcessStatRequestToJSON(document, handler, output);
 }
 
 void MakeBaseSerialize(transport_routine::request_handler::RequestHandler& handler, std::istream& input) {
-    JsonReader document(json::Load(input));
+    MakeBaseSerialize(handler, json::Load(input));
+}
+
+void MakeBaseSerialize(transport_routine::request_handler::RequestHandler& handler, json::Document input) {
+    JsonReader document(std::move(input));
     document.ProcessDocumentBaseLoad();
     handler.SetRenderSettings(document.GetRenderSettings());
     detail::AddBaseFromReader(document, handler);
+    handler.BuildNameIndex();
+    handler.BuildPrefixIndex();
+    handler.BuildSpatialIndex();
     std::unique_ptr<transport_router::TransportRouter> t_router =
         transport_router::TransportRouter::TransportRouterBuilder(handler.GetCatalogue(), document.GetRoutingSettings())
             .Build();
@@ -341,18 +700,180 @@ void MakeBaseSerialize(transport_routine::request_handler::RequestHandler& handl
     serialization::SerializeCatalogue(handler, document.GetSerializationSettings());
 }
 
-void PrintFromDeserializedBase(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
+void MakeBaseSerializeStreaming(transport_routine::request_handler::RequestHandler& handler,
+                                const StreamingLoader& load) {
+    using namespace std::literals;
+    detail::BaseStreamLoader loader(handler);
+    json::Document document = load("base_requests"s, [&loader](const std::string&, json::Node raw_request) {
+        loader.AddRequest(std::move(raw_request));
+    });
+    loader.Finish();
+    MakeBaseSerialize(handler, std::move(document));
+}
+
+void MakeBaseSerializeParallel(transport_routine::request_handler::RequestHandler& handler, const ParallelLoader& load,
+                               size_t range_count) {
+    using namespace std::literals;
+    struct ParsedRange {
+        std::vector<transport_routine::request_handler::StopBaseRequest> stops;
+        std::vector<transport_routine::request_handler::BusBaseRequest> buses;
+    };
+    // Каждый диапазон заполняется только своим потоком
+    std::vector<ParsedRange> ranges(std::max<size_t>(range_count, 1));
+    json::Document document =
+        load("base_requests"s, ranges.size(), [&ranges](size_t range, json::Node raw_request) {
+            const std::string& type = raw_request.AsDict().at("type"sv).AsString();
+            if (type == "Stop"sv) {
+                ranges[range].stops.push_back(detail::ParseStopRequest(raw_request));
+            } else if (type == "Bus"sv) {
+                ranges[range].buses.push_back(detail::ParseBusRequest(raw_request));
+            }
+        });
+
+    std::vector<transport_routine::request_handler::StopBaseRequest> stops;
+    std::vector<transport_routine::request_handler::BusBaseRequest> buses;
+    for (ParsedRange& range : ranges) {
+        std::move(range.stops.begin(), range.stops.end(), std::back_inserter(stops));
+        std::move(range.buses.begin(), range.buses.end(), std::back_inserter(buses));
+        range = {};
+    }
+    detail::AddBase(stops, buses, handler);
+    MakeBaseSerialize(handler, std::move(document));
+}
+
+void PrintFromDeserializedBase(transport_routine::snapshot::SnapshotStore& store, std::istream& input,
                                std::ostream& output) {
-    JsonReader document(json::Load(input));
+    PrintFromDeserializedBase(store, json::Load(input), output);
+}
+
+void PrintFromDeserializedBase(transport_routine::snapshot::SnapshotStore& store, json::Document input,
+                               std::ostream& output) {
+    JsonReader document(std::move(input));
     document.ProcessDocumentRequestLoad();
-    serialization::DeserializeCatalogue(handler, document.GetSerializationSettings());
+    store.Publish(detail::LoadSnapshot(document.GetSerializationSettings()));
 
     if (document.GetStatRequests().empty()) {
         return;
     }
 
-    json::Document result = ProcessStatRequestToJSON(document, handler);
-    json::Print(result, output);
+    transport_routine::snapshot::SnapshotStore::Reader reader(store);
+    const transport_routine::snapshot::SnapshotStore::ReadGuard version = reader.Acquire();
+    ProcessStatRequestToJSON(document, version->handler, output);
+}
+
+void ProcessRequestStream(transport_routine::snapshot::SnapshotStore& store, json::Document settings,
+                          std::istream& input, std::ostream& output) {
+    using namespace std::literals;
+    JsonReader document(std::move(settings));
+    document.ProcessDocumentRequestLoad();
+    store.Publish(detail::LoadSnapshot(document.GetSerializationSettings()));
+
+    // Строки ответов пишут поток чтения и поток загрузки новой версии, каждая строка пишется целиком под мьютексом
+    std::mutex output_mutex;
+    const auto write_line = [&output, &output_mutex](const auto& write) {
+        std::lock_guard guard(output_mutex);
+        json::Writer writer(output, true);
+        write(writer);
+        output << '\n';
+        output.flush();
+    };
+    const auto write_error = [&write_line](std::optional<int> id, const std::exception& e) {
+        write_line([id, &e](json::Writer& writer) {
+            writer.StartDict();
+            if (id) {
+                writer.Key("request_id"s).Value(*id);
+            }
+            writer.Key("error_message"s).Value(std::string(e.what()));
+            writer.EndDict();
+        });
+    };
+
+    transport_routine::snapshot::SnapshotStore::Reader reader(store);
+    // Версия базы захватывается на время одного запроса
+    const auto answer = [&reader, &write_line](const transport_routine::request_handler::StatRequest& request) {
+        const transport_routine::snapshot::SnapshotStore::ReadGuard version = reader.Acquire();
+        write_line([&request, &version](json::Writer& writer) {
+            detail::WriteStatResponse(writer, request, version->handler);
+        });
+    };
+    for (const transport_routine::request_handler::StatRequest& request : document.GetStatRequests()) {
+        answer(request);
+    }
+
+    // Новая версия строится вне потока чтения, чтобы запросы не ждали загрузки. Одновременно загружается
+    // одна версия: следующая перезагрузка ждёт завершения предыдущей
+    std::thread loader;
+    const auto reload = [&store, &loader, &write_line, &write_error](int id,
+                                                                     serialization::SerializationSettings settings) {
+        if (loader.joinable()) {
+            loader.join();
+        }
+        loader = std::thread([&store, &write_line, &write_error, id, settings = std::move(settings)] {
+            try {
+                if (!std::ifstream(settings.file, std::ios::binary)) {
+                    throw std::invalid_argument("Cannot open base file "s + settings.file);
+                }
+                // Файл, который не удалось разобрать, не публикуется: запросы продолжают выполняться по прежней версии
+                store.Publish(detail::LoadSnapshot(settings));
+                const uint64_t epoch = store.GetEpoch();
+                write_line([id, epoch](json::Writer& writer) {
+                    writer.StartDict()
+                        .Key("request_id"s)
+                        .Value(id)
+                        .Key("epoch"s)
+                        .Value(static_cast<int>(epoch))
+                        .EndDict();
+                });
+                // Прежняя версия освобождается здесь, а не в потоке чтения: читатель держит её не дольше одного запроса
+                while (!store.Reclaim()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            } catch (const std::exception& e) {
+                write_error(id, e);
+            }
+        });
+    };
+
+    // Связанный с input поток (std::cin связан с std::cout) сбрасывался бы при каждом чтении без мьютекса вывода,
+    // одновременно с записью потока загрузки. Ответы и так сбрасываются построчно
+    std::ostream* const tied_output = input.tie(nullptr);
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.find_first_not_of(" \t\r"sv) == std::string::npos) {
+            continue;
+        }
+        // Ошибочная строка не прерывает поток: вместо ответа выводится error_message, а если у запроса удалось
+        // прочитать id — и request_id, чтобы ошибку можно было сопоставить с запросом
+        std::optional<int> id;
+        try {
+            json::Document raw_request = json::Load(std::string_view(line));
+            const json::Dict& root = raw_request.GetRoot().AsDict();
+            if (const auto id_it = root.find("id"sv); id_it != root.end() && id_it->second.IsInt()) {
+                id = id_it->second.AsInt();
+            }
+            if (root.at("type"sv).AsString() == "Reload"sv) {
+                if (!id) {
+                    throw std::out_of_range("Missing field: id"s);
+                }
+                JsonReader update(std::move(raw_request));
+                update.ProcessDocumentRequestLoad();
+                reload(*id, update.GetSerializationSettings());
+                continue;
+            }
+            const std::optional<transport_routine::request_handler::StatRequest> request =
+                detail::ParseStatRequest(raw_request.GetRoot());
+            if (!request) {
+                throw std::invalid_argument("Unknown request type"s);
+            }
+            answer(*request);
+        } catch (const std::exception& e) {
+            write_error(id, e);
+        }
+    }
+    if (loader.joinable()) {
+        loader.join();
+    }
+    input.tie(tied_output);
 }
 
 void PrintMapFromJSON(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
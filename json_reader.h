@@ -1,16 +1,21 @@
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <variant>
 #include <vector>
 
 #include "json.h"
 #include "json_builder.h"
+#include "json_writer.h"
 #include "map_renderer.h"
 #include "request_handler.h"
 #include "serialization.h"
+#include "snapshot.h"
 #include "svg.h"
 #include "transport_router.h"
 
@@ -21,7 +26,7 @@ class JsonReader {
     explicit JsonReader(json::Document document);
     const std::vector<transport_routine::request_handler::StopBaseRequest>& GetStopRequests() const;
     const std::vector<transport_routine::request_handler::BusBaseRequest>& GetBusRequests() const;
-    const std::vector<std::unique_ptr<transport_routine::request_handler::StatRequest>>& GetStatRequests() const;
+    const std::vector<transport_routine::request_handler::StatRequest>& GetStatRequests() const;
     const map_renderer::RenderSettings& GetRenderSettings() const;
     const transport_router::RoutingSettings& GetRoutingSettings() const;
     const serialization::SerializationSettings& GetSerializationSettings() const;
@@ -33,15 +38,13 @@ class JsonReader {
     json::Document raw_document_;
     std::vector<transport_routine::request_handler::StopBaseRequest> stop_base_requests_;
     std::vector<transport_routine::request_handler::BusBaseRequest> bus_base_requests_;
-    std::vector<std::unique_ptr<transport_routine::request_handler::StatRequest>> stat_requests_;
+    std::vector<transport_routine::request_handler::StatRequest> stat_requests_;
     map_renderer::RenderSettings render_settings_;
     transport_router::RoutingSettings routing_settings_;
     serialization::SerializationSettings serialization_settings_;
 
     void ProcessBaseRequests();
     void ProcessStatRequests();
-    void ProcessStopRequests(const json::Array& stop_raw_requests);
-    void ProcessBusRequests(const json::Array& bus_raw_requests);
     void ProcessRenderSettings();
     void ProcessRoutingSettings();
     void ProcessSerializationSettings();
@@ -55,26 +58,109 @@ struct ColorReader {
     svg::Color operator()(...) const;
 };
 
+// Строки перемещаются из узла запроса в результат
+transport_routine::request_handler::StopBaseRequest ParseStopRequest(json::Node& stop_raw_request);
+
+transport_routine::request_handler::BusBaseRequest ParseBusRequest(json::Node& bus_raw_request);
+
+// Запрос к базе из узла stat_requests, строки перемещаются из узла. nullopt — неизвестный тип запроса
+std::optional<transport_routine::request_handler::StatRequest> ParseStatRequest(json::Node& stat_request);
+
+// Добавляет запросы base_requests в каталог по одному, по мере разбора документа.
+// Остановка добавляется сразу, расстояния от неё откладываются до Finish: в них могут встречаться остановки,
+// описанные позже. Маршрут добавляется сразу, если все его остановки уже известны и ни один предыдущий маршрут
+// не отложен, иначе откладывается до Finish. Порядок остановок, расстояний и маршрутов в каталоге тот же,
+// что и при загрузке всего документа через AddBase.
+class BaseStreamLoader {
+   public:
+    explicit BaseStreamLoader(transport_routine::request_handler::RequestHandler& handler);
+
+    void AddRequest(json::Node raw_request);
+
+    void Finish();
+
+   private:
+    struct DeferredDistance {
+        std::string from;
+        std::string to;
+        int distance = 0;
+    };
+
+    transport_routine::request_handler::RequestHandler& handler_;
+    std::vector<DeferredDistance> distances_;
+    std::vector<transport_routine::request_handler::BusBaseRequest> buses_;
+    bool is_bulk_load_ = false;
+
+    void StartBulkLoad();
+};
+
 void AddBase(const std::vector<transport_routine::request_handler::StopBaseRequest>& stop_base_requests,
              const std::vector<transport_routine::request_handler::BusBaseRequest>& bus_base_requests,
              transport_routine::request_handler::RequestHandler& handler);
 
+// Отчёт о памяти: словарь "структура": байты и итоговое поле total. Значения больше INT_MAX выводятся как double
+json::Dict MemoryReportToJSON(const memory_usage::MemoryReport& report);
+
 void AddBaseFromReader(const json_reader::JsonReader& reader,
                        transport_routine::request_handler::RequestHandler& handler);
 
+// Новая версия базы из сохранённого файла
+std::unique_ptr<transport_routine::snapshot::Snapshot> LoadSnapshot(
+    const serialization::SerializationSettings& settings);
+
+// Выполняет запрос к базе и записывает ответ: словарь с request_id
+void WriteStatResponse(json::Writer& writer, const transport_routine::request_handler::StatRequest& request,
+                       const transport_routine::request_handler::RequestHandler& handler);
+
 }  // namespace detail
 
-json::Document ProcessStatRequestToJSON(const JsonReader& document,
-                                        transport_routine::request_handler::RequestHandler& handler);
+// Отвечает на запросы к базе, записывая ответы в output по мере готовности, без построения дерева ответа
+void ProcessStatRequestToJSON(const JsonReader& document,
+                              const transport_routine::request_handler::RequestHandler& handler, std::ostream& output);
 
 void ProcessJsonRequest(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
                         std::ostream& output);
 
 void MakeBaseSerialize(transport_routine::request_handler::RequestHandler& handler, std::istream& input);
 
-void PrintFromDeserializedBase(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
+void MakeBaseSerialize(transport_routine::request_handler::RequestHandler& handler, json::Document input);
+
+// Разбирает входной документ, передавая элементы массива под ключом streamed_key в on_item,
+// например json::LoadFileStreaming
+using StreamingLoader =
+    std::function<json::Document(const std::string& streamed_key, const json::ItemHandler& on_item)>;
+
+// Построение базы без дерева base_requests в памяти: запросы добавляются в каталог по мере разбора
+void MakeBaseSerializeStreaming(transport_routine::request_handler::RequestHandler& handler,
+                                const StreamingLoader& load);
+
+// Разбирает входной документ, параллельно передавая элементы массива под ключом split_key в on_item
+// по range_count диапазонам, например json::LoadFileParallel
+using ParallelLoader = std::function<json::Document(const std::string& split_key, size_t range_count,
+                                                    const json::RangeItemHandler& on_item)>;
+
+// Построение базы с параллельным разбором base_requests: каждый диапазон запросов разбирается в своём потоке,
+// затем диапазоны объединяются в исходном порядке и добавляются в каталог так же, как через AddBase
+void MakeBaseSerializeParallel(transport_routine::request_handler::RequestHandler& handler, const ParallelLoader& load,
+                               size_t range_count);
+
+// Загружает сохранённую базу новой версией хранилища и отвечает на запросы по опубликованной версии
+void PrintFromDeserializedBase(transport_routine::snapshot::SnapshotStore& store, std::istream& input,
                                std::ostream& output);
 
+void PrintFromDeserializedBase(transport_routine::snapshot::SnapshotStore& store, json::Document input,
+                               std::ostream& output);
+
+// Построчный режим: settings задаёт serialization_settings и, возможно, stat_requests. База загружается один раз,
+// затем каждая непустая строка input — запрос к базе в формате элемента stat_requests. На каждый запрос,
+// включая stat_requests из settings, в output пишется и сразу сбрасывается одна строка ответа.
+// Строка {"id": ..., "type": "Reload", "serialization_settings": {...}} загружает базу из другого файла в фоновом
+// потоке. Пока загрузка идёт, запросы выполняются по прежней версии. После публикации новой версии выводится
+// строка {"request_id": ..., "epoch": ...}, запросы после неё выполняются по новой версии. Если файл не открылся
+// или не разобрался, версия не меняется, выводится error_message с request_id перезагрузки
+void ProcessRequestStream(transport_routine::snapshot::SnapshotStore& store, json::Document settings,
+                          std::istream& input, std::ostream& output);
+
 void PrintMapFromJSON(transport_routine::request_handler::RequestHandler& handler, std::istream& input,
                       std::ostream& output);
 
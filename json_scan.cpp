@@ -0,0 +1,183 @@
+#include "json_scan.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define JSON_SCAN_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__)
+// GCC и Clang собирают отдельные функции под AVX2 и проверяют поддержку процессором во время выполнения
+#define JSON_SCAN_AVX2
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace json {
+
+namespace scan {
+
+namespace {
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool IsStringSpecial(char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\r';
+}
+
+const char* FindStringSpecialScalar(const char* first, const char* last) {
+    while (first != last && !IsStringSpecial(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+const char* SkipSpacesScalar(const char* first, const char* last) {
+    while (first != last && IsSpace(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+#ifdef JSON_SCAN_SSE2
+
+uint32_t CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+const int SSE2_WIDTH = 16;
+
+__m128i StringSpecialMaskSse2(__m128i chunk) {
+    const __m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+    const __m128i line_ends = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                                           _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')));
+    return _mm_or_si128(quotes, line_ends);
+}
+
+// Пробельные символы — ' ' и диапазон '\t'..'\r': после вычитания '\t' диапазон проверяется
+// одним беззнаковым сравнением с насыщением
+__m128i SpaceMaskSse2(__m128i chunk) {
+    const __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+    const __m128i in_range =
+        _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8('\r' - '\t')), _mm_setzero_si128());
+    return _mm_or_si128(in_range, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+}
+
+const char* FindStringSpecialSse2(const char* first, const char* last) {
+    for (; last - first >= SSE2_WIDTH; first += SSE2_WIDTH) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(StringSpecialMaskSse2(chunk)));
+        if (mask != 0) {
+            return first + CountTrailingZeros(mask);
+        }
+    }
+    return FindStringSpecialScalar(first, last);
+}
+
+const char* SkipSpacesSse2(const char* first, const char* last) {
+    for (; last - first >= SSE2_WIDTH; first += SSE2_WIDTH) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(SpaceMaskSse2(chunk))) & 0xFFFFu;
+        if (mask != 0) {
+            return first + CountTrailingZeros(mask);
+        }
+    }
+    return SkipSpacesScalar(first, last);
+}
+
+#endif
+
+#ifdef JSON_SCAN_AVX2
+
+const int AVX2_WIDTH = 32;
+
+__attribute__((target("avx2"))) __m256i StringSpecialMaskAvx2(__m256i chunk) {
+    const __m256i quotes = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                                           _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+    const __m256i line_ends = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+                                              _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')));
+    return _mm256_or_si256(quotes, line_ends);
+}
+
+__attribute__((target("avx2"))) __m256i SpaceMaskAvx2(__m256i chunk) {
+    const __m256i shifted = _mm256_sub_epi8(chunk, _mm256_set1_epi8('\t'));
+    const __m256i in_range =
+        _mm256_cmpeq_epi8(_mm256_subs_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), _mm256_setzero_si256());
+    return _mm256_or_si256(in_range, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) const char* FindStringSpecialAvx2(const char* first, const char* last) {
+    for (; last - first >= AVX2_WIDTH; first += AVX2_WIDTH) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(StringSpecialMaskAvx2(chunk)));
+        if (mask != 0) {
+            return first + CountTrailingZeros(mask);
+        }
+    }
+    return FindStringSpecialSse2(first, last);
+}
+
+__attribute__((target("avx2"))) const char* SkipSpacesAvx2(const char* first, const char* last) {
+    for (; last - first >= AVX2_WIDTH; first += AVX2_WIDTH) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(SpaceMaskAvx2(chunk)));
+        if (mask != 0) {
+            return first + CountTrailingZeros(mask);
+        }
+    }
+    return SkipSpacesSse2(first, last);
+}
+
+#endif
+
+using ScanFunc = const char* (*)(const char* first, const char* last);
+
+struct Implementation {
+    ScanFunc find_string_special;
+    ScanFunc skip_spaces;
+};
+
+Implementation SelectImplementation() {
+#ifdef JSON_SCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {FindStringSpecialAvx2, SkipSpacesAvx2};
+    }
+#endif
+#ifdef JSON_SCAN_SSE2
+    return {FindStringSpecialSse2, SkipSpacesSse2};
+#else
+    return {FindStringSpecialScalar, SkipSpacesScalar};
+#endif
+}
+
+const Implementation IMPLEMENTATION = SelectImplementation();
+
+}  // namespace
+
+const char* FindStringSpecial(const char* first, const char* last) {
+    return IMPLEMENTATION.find_string_special(first, last);
+}
+
+const char* SkipSpaces(const char* first, const char* last) {
+    // Между лексемами обычно не больше одного пробела, поэтому сначала проверяется первый символ
+    if (first != last && !IsSpace(*first)) {
+        return first;
+    }
+    return IMPLEMENTATION.skip_spaces(first, last);
+}
+
+}  // namespace scan
+
+}  // namespace json
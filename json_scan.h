@@ -0,0 +1,19 @@
+#pragma once
+
+namespace json {
+
+namespace scan {
+
+// Поиск символов, на которых останавливается разбор, по 16–32 байта за шаг. Реализация выбирается при запуске
+// по возможностям процессора: AVX2, SSE2 или побайтовый просмотр на остальных архитектурах
+
+// Первый символ в [first, last), на котором заканчивается простой участок строкового литерала:
+// кавычка, обратная косая черта, \n или \r. Если такого нет — last
+const char* FindStringSpecial(const char* first, const char* last);
+
+// Первый непробельный символ в [first, last). Если такого нет — last
+const char* SkipSpaces(const char* first, const char* last);
+
+}  // namespace scan
+
+}  // namespace json
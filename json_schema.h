@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+namespace schema {
+
+// FNV-1a. Для имён полей вычисляется при компиляции, для ключей словаря — один раз при проходе по нему
+constexpr uint64_t HashKey(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Поле схемы: имя, его хеш и функция set(структура, узел), записывающая значение узла в структуру
+template <typename Setter>
+struct Field {
+    std::string_view name;
+    uint64_t hash = 0;
+    Setter set;
+    bool is_required = true;
+};
+
+// Чтение значения узла. Из изменяемого узла строки и ключи словарей перемещаются
+inline void ReadValue(const Node& node, int& out) {
+    out = node.AsInt();
+}
+
+inline void ReadValue(const Node& node, double& out) {
+    out = node.AsDouble();
+}
+
+inline void ReadValue(const Node& node, bool& out) {
+    out = node.AsBool();
+}
+
+inline void ReadValue(const Node& node, std::string& out) {
+    out = node.AsString();
+}
+
+inline void ReadValue(Node& node, std::string& out) {
+    out = std::move(node.AsString());
+}
+
+template <typename NodeType, typename T>
+void ReadValue(NodeType& node, std::optional<T>& out) {
+    ReadValue(node, out.emplace());
+}
+
+template <typename NodeType, typename T>
+void ReadValue(NodeType& node, std::vector<T>& out) {
+    auto& array = node.AsArray();
+    out.clear();
+    out.reserve(array.size());
+    for (auto& item : array) {
+        ReadValue(item, out.emplace_back());
+    }
+}
+
+template <typename T>
+void ReadValue(const Node& node, std::map<std::string, T>& out) {
+    for (const auto& [key, value] : node.AsDict()) {
+        ReadValue(value, out[key]);
+    }
+}
+
+// Ключи перемещаются, поэтому словарь в узле очищается
+template <typename T>
+void ReadValue(Node& node, std::map<std::string, T>& out) {
+    Dict& dict = node.AsDict();
+    for (auto& [key, value] : dict) {
+        ReadValue(value, out[std::move(key)]);
+    }
+    dict.clear();
+}
+
+// Обязательное поле с произвольной функцией записи set(структура, узел)
+template <typename Setter>
+constexpr Field<Setter> Required(std::string_view name, Setter set) {
+    return {name, HashKey(name), set, true};
+}
+
+template <typename Setter>
+constexpr Field<Setter> Optional(std::string_view name, Setter set) {
+    return {name, HashKey(name), set, false};
+}
+
+// Поле, значение которого читается в член структуры
+template <typename Struct, typename Member>
+constexpr auto Required(std::string_view name, Member Struct::*member) {
+    return Required(name, [member](Struct& out, auto& value) {
+        ReadValue(value, out.*member);
+    });
+}
+
+template <typename Struct, typename Member>
+constexpr auto Optional(std::string_view name, Member Struct::*member) {
+    return Optional(name, [member](Struct& out, auto& value) {
+        ReadValue(value, out.*member);
+    });
+}
+
+namespace detail {
+
+template <typename Schema, typename NodeType, typename Struct, size_t... I>
+void MatchField(const Schema& schema, std::string_view key, uint64_t hash, NodeType& value, Struct& out,
+                uint64_t& found, std::index_sequence<I...>) {
+    ((std::get<I>(schema).hash == hash && std::get<I>(schema).name == key &&
+      (std::get<I>(schema).set(out, value), found |= uint64_t{1} << I, true)) ||
+     ...);
+}
+
+template <typename Schema, size_t... I>
+void CheckRequired(const Schema& schema, uint64_t found, std::index_sequence<I...>) {
+    using namespace std::literals;
+    (((!std::get<I>(schema).is_required || (found >> I & 1) != 0)
+          ? void()
+          : throw std::out_of_range("Missing field: "s + std::string(std::get<I>(schema).name))),
+     ...);
+}
+
+}  // namespace detail
+
+// Заполняет out из словаря за один проход по его парам: ключ сравнивается с полями схемы по хешу,
+// при совпадении хеша — по строке. Ключи, которых нет в схеме, пропускаются. Если в словаре нет обязательного
+// поля, бросает std::out_of_range. Схема — кортеж полей, созданных Required и Optional
+template <typename DictType, typename Struct, typename... Fields>
+void Extract(DictType& dict, Struct& out, const std::tuple<Fields...>& schema) {
+    static_assert(sizeof...(Fields) <= 64, "Schema is limited to 64 fields");
+    uint64_t found = 0;
+    for (auto& [key, value] : dict) {
+        detail::MatchField(schema, key, HashKey(key), value, out, found, std::index_sequence_for<Fields...>{});
+    }
+    detail::CheckRequired(schema, found, std::index_sequence_for<Fields...>{});
+}
+
+}  // namespace schema
+
+}  // namespace json
@@ -0,0 +1,165 @@
+#include "json_writer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace json {
+
+using namespace std::literals;
+
+namespace {
+
+// Буфер сбрасывается в поток, когда очередной элемент корневого массива делает его больше этого размера
+const std::streamoff FLUSH_SIZE = 64 * 1024;
+
+}  // namespace
+
+Writer::Writer(std::ostream& output, bool compact, int depth) : output_(output), compact_(compact), depth_(depth) {
+}
+
+Writer::DictValueContext Writer::Key(std::string key) {
+    if (frames_.empty() || !frames_.back().is_dict || frames_.back().key) {
+        throw std::logic_error("Incorrect Dict key insertion"s);
+    }
+    frames_.back().key = std::move(key);
+    return BaseContext(*this);
+}
+
+Writer::BaseContext Writer::Value(json::Value value) {
+    BeginValue();
+    detail::PrintNode(Node(std::move(value)), Context(Target()));
+    EndValue();
+    return BaseContext(*this);
+}
+
+Writer::BaseContext Writer::RawValue(std::string_view text) {
+    BeginValue();
+    Target() << text;
+    EndValue();
+    return BaseContext(*this);
+}
+
+Writer::DictItemContext Writer::StartDict() {
+    BeginValue();
+    frames_.emplace_back().is_dict = true;
+    return BaseContext(*this);
+}
+
+Writer::ArrayItemContext Writer::StartArray() {
+    BeginValue();
+    std::ostream& out = Target();
+    out << "["sv;
+    Context(out).PrintLineBreak();
+    frames_.emplace_back();
+    return BaseContext(*this);
+}
+
+Writer::BaseContext Writer::EndDict() {
+    if (frames_.empty() || !frames_.back().is_dict || frames_.back().key) {
+        throw std::logic_error("Trying to close incomplete sequence or no Dict start found"s);
+    }
+    std::vector<std::pair<std::string, std::string>> items = std::move(frames_.back().items);
+    frames_.pop_back();
+    std::stable_sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    std::ostream& out = Target();
+    const PrintContext ctx = Context(out);
+    const PrintContext inner_ctx = ctx.Indented();
+    out << "{"sv;
+    ctx.PrintLineBreak();
+    bool is_first = true;
+    for (const auto& [key, value] : items) {
+        if (is_first) {
+            is_first = false;
+        } else {
+            out << ","sv;
+            ctx.PrintLineBreak();
+        }
+        inner_ctx.PrintIndent();
+        out << "\""sv << key << "\""sv << ctx.KeySeparator() << value;
+    }
+    ctx.PrintLineBreak();
+    ctx.PrintIndent();
+    out << "}"sv;
+    EndValue();
+    return BaseContext(*this);
+}
+
+Writer::BaseContext Writer::EndArray() {
+    if (frames_.empty() || frames_.back().is_dict) {
+        throw std::logic_error("Trying to close incomplete sequence or no Array start found"s);
+    }
+    frames_.pop_back();
+    std::ostream& out = Target();
+    const PrintContext ctx = Context(out);
+    ctx.PrintLineBreak();
+    ctx.PrintIndent();
+    out << "]"sv;
+    EndValue();
+    return BaseContext(*this);
+}
+
+std::ostream& Writer::Target() {
+    for (auto it = frames_.rbegin(); it != frames_.rend(); ++it) {
+        if (it->is_dict) {
+            return it->value;
+        }
+    }
+    return buffer_;
+}
+
+PrintContext Writer::Context(std::ostream& out) const {
+    PrintContext ctx{out};
+    ctx.indent = (depth_ + static_cast<int>(frames_.size())) * ctx.indent_step;
+    ctx.compact = compact_;
+    return ctx;
+}
+
+void Writer::BeginValue() {
+    if (frames_.empty()) {
+        if (is_root_started_) {
+            throw std::logic_error("Multivalued node must be Array or Dict. Cannot insert value"s);
+        }
+        is_root_started_ = true;
+        return;
+    }
+    Frame& frame = frames_.back();
+    if (frame.is_dict) {
+        if (!frame.key) {
+            throw std::logic_error("Trying to assign value to Dict with no key associated"s);
+        }
+        return;
+    }
+    const PrintContext ctx = Context(Target());
+    if (!frame.is_first) {
+        ctx.out << ","sv;
+        ctx.PrintLineBreak();
+    }
+    frame.is_first = false;
+    ctx.PrintIndent();
+}
+
+void Writer::EndValue() {
+    if (frames_.empty()) {
+        Flush();
+        return;
+    }
+    Frame& frame = frames_.back();
+    if (frame.is_dict) {
+        frame.items.emplace_back(std::move(*frame.key), frame.value.str());
+        frame.key.reset();
+        frame.value.str({});
+    } else if (frames_.size() == 1 && buffer_.tellp() >= FLUSH_SIZE) {
+        Flush();
+    }
+}
+
+void Writer::Flush() {
+    const std::string data = buffer_.str();
+    output_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    buffer_.str({});
+}
+
+}  // namespace json
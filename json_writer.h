@@ -0,0 +1,79 @@
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+#include "json_context.h"
+
+namespace json {
+
+// Потоковая запись JSON с тем же интерфейсом, что у json::Builder, но без построения дерева.
+// Элементы массивов записываются по мере поступления, а пары словаря копятся до EndDict, чтобы
+// вывести их по возрастанию ключа: результат совпадает с json::Print побайтно. Память ограничена
+// размером одного словаря. Вывод буферизуется и сбрасывается в поток крупными блоками,
+// последний блок — при закрытии корневого значения
+class Writer {
+public:
+    using BaseContext = detail::BaseContext<Writer>;
+    using DictValueContext = detail::DictValueContext<Writer>;
+    using DictItemContext = detail::DictItemContext<Writer>;
+    using ArrayItemContext = detail::ArrayItemContext<Writer>;
+
+    // compact — весь документ в одну строку, как для построчного протокола.
+    // depth — глубина вложенности, на которой записанное значение будет вставлено через RawValue
+    explicit Writer(std::ostream& output, bool compact = false, int depth = 0);
+
+    DictValueContext Key(std::string key);
+
+    BaseContext Value(json::Value value);
+
+    // Значение, уже записанное другим Writer с тем же compact и depth, равной текущей глубине вложенности
+    BaseContext RawValue(std::string_view text);
+
+    DictItemContext StartDict();
+
+    ArrayItemContext StartArray();
+
+    BaseContext EndDict();
+
+    BaseContext EndArray();
+
+private:
+    // Открытый массив или словарь
+    struct Frame {
+        bool is_dict = false;
+        // Массив: ещё не записано ни одного элемента
+        bool is_first = true;
+        // Словарь: ключ значения, которое записывается сейчас, сама запись и готовые пары
+        std::optional<std::string> key;
+        std::ostringstream value;
+        std::vector<std::pair<std::string, std::string>> items;
+    };
+
+    std::ostream& output_;
+    bool compact_;
+    int depth_;
+    std::ostringstream buffer_;
+    std::vector<Frame> frames_;
+    bool is_root_started_ = false;
+
+    // Поток, в который пишется текущее значение: запись значения ближайшего словаря или общий буфер
+    std::ostream& Target();
+
+    // Контекст вывода значения на текущей глубине вложенности
+    PrintContext Context(std::ostream& out) const;
+
+    void BeginValue();
+
+    void EndValue();
+
+    void Flush();
+};
+
+}  // namespace json
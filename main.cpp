@@ -1,37 +1,121 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <thread>
 
+#include "json.h"
 #include "json_reader.h"
 #include "map_renderer.h"
+#include "memory_usage.h"
 #include "request_handler.h"
+#include "snapshot.h"
 #include "transport_catalogue.h"
 
 using namespace std::literals;
 
 void PrintUsage(std::ostream& stream = std::cerr) {
-    stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+    stream << "Usage: transport_catalogue [make_base|process_requests|process_stream] [--memory-usage] "sv
+           << "[--parallel] [--input <file>]\n"sv;
+}
+
+// Входной документ из файла, если он указан, иначе из стандартного ввода
+json::Document LoadInput(const std::optional<std::string>& input_path) {
+    return input_path ? json::LoadFile(*input_path) : json::Load(std::cin);
+}
+
+// Настройки построчного режима: из файла, если он указан, иначе из первой строки стандартного ввода
+json::Document LoadStreamSettings(const std::optional<std::string>& input_path) {
+    if (input_path) {
+        return json::LoadFile(*input_path);
+    }
+    std::string line;
+    std::getline(std::cin, line);
+    return json::Load(std::string_view(line));
+}
+
+// Построчно "структура байты" для каталога и маршрутизатора
+void PrintMemoryUsage(const transport_routine::request_handler::RequestHandler& handler,
+                      std::ostream& stream = std::cerr) {
+    memory_usage::MemoryReport report;
+    report.Merge("catalogue"s, handler.GetCatalogueMemoryUsage());
+    report.Merge("transport_router"s, handler.GetRouterMemoryUsage());
+    for (const auto& [name, bytes] : report.items) {
+        stream << name << ' ' << bytes << '\n';
+    }
+    stream << "total "sv << report.Total() << '\n';
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    if (argc < 2) {
         PrintUsage();
         return 1;
     }
 
     const std::string_view mode(argv[1]);
+    bool print_memory_usage = false;
+    bool is_parallel = false;
+    std::optional<std::string> input_path;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg == "--memory-usage"sv) {
+            print_memory_usage = true;
+        } else if (arg == "--parallel"sv) {
+            is_parallel = true;
+        } else if (arg == "--input"sv && i + 1 < argc) {
+            input_path = argv[++i];
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
 
     if (mode == "make_base"sv) {
         transport_routine::catalogue::TransportCatalogue cat;
         map_renderer::MapRenderer renderer;
         transport_routine::request_handler::RequestHandler handler(cat, renderer);
-        json_reader::MakeBaseSerialize(handler, std::cin);
+        // По умолчанию base_requests разбирается потоково, без хранения запросов. С --parallel запросы разбираются
+        // параллельно: быстрее на нескольких ядрах, но все разобранные запросы хранятся до добавления в каталог
+        const size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+        if (is_parallel) {
+            json_reader::MakeBaseSerializeParallel(
+                handler,
+                [&input_path](const std::string& split_key, size_t range_count, const json::RangeItemHandler& on_item) {
+                    return input_path ? json::LoadFileParallel(*input_path, split_key, range_count, on_item)
+                                      : json::LoadParallel(std::cin, split_key, range_count, on_item);
+                },
+                thread_count);
+        } else {
+            json_reader::MakeBaseSerializeStreaming(
+                handler, [&input_path](const std::string& streamed_key, const json::ItemHandler& on_item) {
+                    return input_path ? json::LoadFileStreaming(*input_path, streamed_key, on_item)
+                                      : json::LoadStreaming(std::cin, streamed_key, on_item);
+                });
+        }
+        if (print_memory_usage) {
+            // Индекс принадлежности не сериализуется: process_requests строит его при загрузке базы.
+            // Здесь он строится только для отчёта, чтобы отчёт учитывал все индексы загруженной базы
+            handler.BuildMembershipIndex();
+            PrintMemoryUsage(handler);
+        }
 
     } else if (mode == "process_requests"sv) {
-        transport_routine::catalogue::TransportCatalogue cat;
-        map_renderer::MapRenderer renderer;
-        transport_routine::request_handler::RequestHandler handler(cat, renderer);
-        json_reader::PrintFromDeserializedBase(handler, std::cin, std::cout);
+        transport_routine::snapshot::SnapshotStore store;
+        json_reader::PrintFromDeserializedBase(store, LoadInput(input_path), std::cout);
+        if (print_memory_usage) {
+            transport_routine::snapshot::SnapshotStore::Reader reader(store);
+            const transport_routine::snapshot::SnapshotStore::ReadGuard version = reader.Acquire();
+            if (version.Get()) {
+                PrintMemoryUsage(version->handler);
+            }
+        }
+    } else if (mode == "process_stream"sv) {
+        // Запросы читаются построчно, синхронизация с stdio только замедляла бы getline
+        std::ios::sync_with_stdio(false);
+        transport_routine::snapshot::SnapshotStore store;
+        json_reader::ProcessRequestStream(store, LoadStreamSettings(input_path), std::cin, std::cout);
     } else {
         PrintUsage();
         return 1;
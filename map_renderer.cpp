@@ -29,14 +29,16 @@ const RenderSettings& MapRenderer::GetRenderSettings() const {
     return settings_;
 }
 
-svg::Document MapRenderer::RenderRouteMap(const SortedRoutes& routes) const {
+svg::Document MapRenderer::RenderRouteMap(const SortedRoutes& routes,
+                                          const std::deque<transport_routine::domain::Stop>& stops) const {
     using namespace std::literals;
     svg::Document ret;
     std::vector<geo::Coordinates> all_points;
     SortedStops all_stops;
-    std::for_each(routes.begin(), routes.end(), [&all_points, &all_stops](const auto bus) {
+    std::for_each(routes.begin(), routes.end(), [&all_points, &all_stops, &stops](const auto bus) {
         if (!bus->route.empty()) {
-            for (const transport_routine::domain::Stop* stop: bus->route) {
+            for (const transport_routine::domain::StopId stop_id: bus->route) {
+                const transport_routine::domain::Stop* stop = &stops.at(stop_id);
                 all_points.push_back(stop->point);
                 all_stops.insert(stop);
             }
@@ -44,16 +46,16 @@ svg::Document MapRenderer::RenderRouteMap(const SortedRoutes& routes) const {
     });
     detail::SphereProjector projector(all_points.begin(), all_points.end(), settings_.width, settings_.height,
                                       settings_.padding);
-    DrawLines(ret, projector, routes);
-    DrawBusLabels(ret, projector, routes);
+    DrawLines(ret, projector, routes, stops);
+    DrawBusLabels(ret, projector, routes, stops);
     DrawStops(ret, projector, all_stops);
     DrawStopLabels(ret, projector, all_stops);
 
     return ret;
 }
 
-void
-MapRenderer::DrawLines(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes) const {
+void MapRenderer::DrawLines(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes,
+                            const std::deque<transport_routine::domain::Stop>& stops) const {
     using namespace std::literals;
     const size_t MAX_COLOR_INDEX = settings_.color_palette.size() - 1;
     size_t color_index = 0;
@@ -69,12 +71,12 @@ MapRenderer::DrawLines(svg::Document& ret, const detail::SphereProjector& projec
                 SetStrokeWidth(settings_.line_width).
                 SetStrokeLineCap(svg::StrokeLineCap::ROUND).
                 SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
-        for (const auto stop: bus->route) {
-            route_line.AddPoint(projector(stop->point));
+        for (const auto stop_id: bus->route) {
+            route_line.AddPoint(projector(stops[stop_id].point));
         }
         if (!bus->is_roundtrip) {
             for (auto it = next(bus->route.rbegin()); it != bus->route.rend(); ++it) {
-                route_line.AddPoint(projector((*it)->point));
+                route_line.AddPoint(projector(stops[*it].point));
             }
         }
         if (color_index == MAX_COLOR_INDEX) {
@@ -87,7 +89,8 @@ MapRenderer::DrawLines(svg::Document& ret, const detail::SphereProjector& projec
 }
 
 void MapRenderer::DrawBusLabels(svg::Document& ret, const detail::SphereProjector& projector,
-                                const SortedRoutes& routes) const {
+                                const SortedRoutes& routes,
+                                const std::deque<transport_routine::domain::Stop>& stops) const {
     using namespace std::literals;
     const size_t MAX_COLOR_INDEX = settings_.color_palette.size() - 1;
     size_t color_index = 0;
@@ -97,12 +100,12 @@ void MapRenderer::DrawBusLabels(svg::Document& ret, const detail::SphereProjecto
             continue;
         }
         {
-            BusLabel label{UniformBusLabel(bus->name, projector(bus->route.front()->point), color_index)};
+            BusLabel label{UniformBusLabel(bus->name, projector(stops[bus->route.front()].point), color_index)};
             ret.Add(label.route_name_underlayer);
             ret.Add(label.route_name);
         }
         if (!bus->is_roundtrip && (bus->route.front() != bus->route.back())) {
-            BusLabel label{UniformBusLabel(bus->name, projector(bus->route.back()->point), color_index)};
+            BusLabel label{UniformBusLabel(bus->name, projector(stops[bus->route.back()].point), color_index)};
             ret.Add(label.route_name_underlayer);
             ret.Add(label.route_name);
         }
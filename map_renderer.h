@@ -111,7 +111,8 @@ public:
 
     explicit MapRenderer(RenderSettings settings);
 
-    svg::Document RenderRouteMap(const SortedRoutes& routes) const;
+    svg::Document RenderRouteMap(const SortedRoutes& routes,
+                                 const std::deque<transport_routine::domain::Stop>& stops) const;
 
     void SetRenderSettings(RenderSettings render_settings);
 
@@ -125,9 +126,11 @@ private:
         svg::Text route_name;
     };
 
-    void DrawLines(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes) const;
+    void DrawLines(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes,
+                   const std::deque<transport_routine::domain::Stop>& stops) const;
 
-    void DrawBusLabels(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes) const;
+    void DrawBusLabels(svg::Document& ret, const detail::SphereProjector& projector, const SortedRoutes& routes,
+                       const std::deque<transport_routine::domain::Stop>& stops) const;
 
     BusLabel UniformBusLabel(const std::string& name, const svg::Point&, size_t color_index) const;
 
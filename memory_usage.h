@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace memory_usage {
+
+// Занимаемая память по структурам в порядке добавления. Оценка: учитывается ёмкость контейнеров
+// и типичные накладные расходы узлов стандартной библиотеки, служебные данные аллокатора не учитываются.
+struct MemoryReport {
+    std::vector<std::pair<std::string, size_t>> items;
+
+    void Add(std::string name, size_t bytes) { items.emplace_back(std::move(name), bytes); }
+
+    // Добавляет пункты other с именами вида "prefix.name"
+    void Merge(const std::string& prefix, const MemoryReport& other) {
+        for (const auto& [name, bytes] : other.items) {
+            items.emplace_back(prefix + "." + name, bytes);
+        }
+    }
+
+    size_t Total() const {
+        size_t ret = 0;
+        for (const auto& item : items) {
+            ret += item.second;
+        }
+        return ret;
+    }
+};
+
+// Память вне самого объекта строки: ноль, если строка помещается во внутренний буфер
+inline size_t StringHeapBytes(const std::string& str) {
+    const char* data = str.data();
+    const char* object = reinterpret_cast<const char*>(&str);
+    return (data >= object && data < object + sizeof(str)) ? 0 : str.capacity() + 1;
+}
+
+template <typename T>
+size_t VectorBytes(const std::vector<T>& vec) {
+    return vec.capacity() * sizeof(T);
+}
+
+template <typename T>
+size_t DequeBytes(const std::deque<T>& deq) {
+    static const size_t BLOCK_BYTES = 512;
+    const size_t per_block = sizeof(T) < BLOCK_BYTES ? BLOCK_BYTES / sizeof(T) : 1;
+    const size_t blocks = deq.size() / per_block + 1;
+    return blocks * per_block * sizeof(T) + (blocks + 2) * sizeof(void*);
+}
+
+// Узел хранит значение, указатель на следующий узел и закешированный хеш
+template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t UnorderedMapBytes(const std::unordered_map<Key, Value, Hash, Equal, Alloc>& map) {
+    using ValueType = typename std::unordered_map<Key, Value, Hash, Equal, Alloc>::value_type;
+    return map.bucket_count() * sizeof(void*) + map.size() * (sizeof(ValueType) + 2 * sizeof(void*));
+}
+
+// Узел красно-чёрного дерева: значение, три указателя и цвет
+template <typename Key, typename Compare, typename Alloc>
+size_t SetBytes(const std::set<Key, Compare, Alloc>& set) {
+    return set.size() * (sizeof(Key) + 4 * sizeof(void*));
+}
+
+}  // namespace memory_usage
@@ -0,0 +1,29 @@
+#include "number_format.h"
+
+#include <charconv>
+
+namespace number_format {
+
+namespace {
+
+const int DEFAULT_PRECISION = 6;
+// Знак, 6 цифр, точка, экспонента вида e-308, а также inf и nan
+const int MAX_DOUBLE_LENGTH = 32;
+const int MAX_INT_LENGTH = 12;
+
+}  // namespace
+
+void WriteDouble(std::ostream& out, double value) {
+    char buffer[MAX_DOUBLE_LENGTH];
+    const auto result =
+        std::to_chars(buffer, buffer + MAX_DOUBLE_LENGTH, value, std::chars_format::general, DEFAULT_PRECISION);
+    out.write(buffer, result.ptr - buffer);
+}
+
+void WriteInt(std::ostream& out, int value) {
+    char buffer[MAX_INT_LENGTH];
+    const auto result = std::to_chars(buffer, buffer + MAX_INT_LENGTH, value);
+    out.write(buffer, result.ptr - buffer);
+}
+
+}  // namespace number_format
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <ostream>
+
+namespace number_format {
+
+// Вывод чисел через std::to_chars, без учёта локали потока. Запись совпадает с выводом в std::ostream
+// с настройками по умолчанию: не более 6 значащих цифр, экспоненциальная форма для очень больших и малых чисел.
+void WriteDouble(std::ostream& out, double value);
+
+void WriteInt(std::ostream& out, int value);
+
+}  // namespace number_format
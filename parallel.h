@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+namespace detail {
+
+// Истина, пока поток выполняет диапазон ForEachRange
+inline thread_local bool is_inside_range = false;
+
+class RangeScope {
+   public:
+    RangeScope() : previous_(is_inside_range) { is_inside_range = true; }
+    RangeScope(const RangeScope&) = delete;
+    RangeScope& operator=(const RangeScope&) = delete;
+    ~RangeScope() { is_inside_range = previous_; }
+
+   private:
+    bool previous_;
+};
+
+}  // namespace detail
+
+// Делит интервал [first, last) на непрерывные диапазоны не короче min_range_size (кроме последнего)
+// по числу аппаратных потоков и вызывает func(range_first, range_last) для каждого диапазона.
+// Первый диапазон обрабатывается в вызывающем потоке. Возвращает управление после завершения всех диапазонов.
+// Вызов из диапазона другого ForEachRange выполняется целиком в текущем потоке: потоки уже заняты внешним вызовом.
+// Исключение из диапазона выбрасывается после завершения всех диапазонов, из нескольких — исключение первого диапазона
+template <typename Func>
+void ForEachRange(size_t first, size_t last, size_t min_range_size, Func func) {
+    if (first >= last) {
+        return;
+    }
+    if (detail::is_inside_range) {
+        func(first, last);
+        return;
+    }
+    const size_t count = last - first;
+    const size_t thread_count = std::clamp<size_t>(count / std::max<size_t>(min_range_size, 1), 1,
+                                                   std::max(1u, std::thread::hardware_concurrency()));
+    const size_t range_size = (count + thread_count - 1) / thread_count;
+
+    std::vector<std::exception_ptr> errors(thread_count);
+    const auto run_range = [&func, &errors](size_t range, size_t range_first, size_t range_last) {
+        detail::RangeScope scope;
+        try {
+            func(range_first, range_last);
+        } catch (...) {
+            errors[range] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    size_t range = 1;
+    for (size_t range_first = first + range_size; range_first < last; range_first += range_size) {
+        workers.emplace_back(run_range, range++, range_first, std::min(range_first + range_size, last));
+    }
+    run_range(0, first, std::min(first + range_size, last));
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+}  // namespace parallel
@@ -0,0 +1,166 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "memory_usage.h"
+
+namespace perfect_hash {
+
+using namespace std::literals;
+
+namespace detail {
+
+uint64_t HashString(std::string_view str, uint64_t seed) {
+    uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+    for (const char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return Mix(hash);
+}
+
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+}  // namespace detail
+
+PerfectHash::PerfectHash(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values) {
+    if (keys.size() != values.size()) {
+        throw std::invalid_argument("Keys and values count mismatch"s);
+    }
+    if (keys.empty()) {
+        return;
+    }
+
+    // Каждая попытка ограничена бюджетом проб, неудачная попытка повторяется с новым seed и вдвое большим
+    // числом корзин: корзины становятся мельче и размещаются легче
+    static const int MAX_SEED_ATTEMPTS = 8;
+    std::vector<uint64_t> hashes(keys.size());
+    size_t bucket_count = keys.size() / 4 + 1;
+    for (int attempt = 0; attempt < MAX_SEED_ATTEMPTS; ++attempt) {
+        seed_ = detail::Mix(static_cast<uint64_t>(attempt) + 1);
+        std::transform(keys.begin(), keys.end(), hashes.begin(),
+                       [this](std::string_view key) { return detail::HashString(key, seed_); });
+        if (TryBuild(hashes, values, bucket_count)) {
+            return;
+        }
+        bucket_count = std::min(bucket_count * 2, keys.size());
+    }
+    // Индекс не построен (например, ключи повторяются): Find возвращает NPOS,
+    // и вызывающая сторона ищет ключ по своей таблице
+    seed_ = 0;
+    pilots_.clear();
+    slots_.clear();
+}
+
+PerfectHash::PerfectHash(uint64_t seed, std::vector<uint32_t> pilots, std::vector<uint32_t> slots)
+    : seed_(seed), pilots_(std::move(pilots)), slots_(std::move(slots)) {
+    if (!slots_.empty() && pilots_.empty()) {
+        throw std::invalid_argument("Perfect hash without pilots"s);
+    }
+}
+
+uint32_t PerfectHash::Find(std::string_view key) const {
+    if (slots_.empty()) {
+        return NPOS;
+    }
+    const uint64_t hash = detail::HashString(key, seed_);
+    return slots_[SlotOf(hash, pilots_[BucketOf(hash)])];
+}
+
+bool PerfectHash::Empty() const { return slots_.empty(); }
+
+uint64_t PerfectHash::GetSeed() const { return seed_; }
+
+const std::vector<uint32_t>& PerfectHash::GetPilots() const { return pilots_; }
+
+const std::vector<uint32_t>& PerfectHash::GetSlots() const { return slots_; }
+
+size_t PerfectHash::MemoryUsage() const {
+    return memory_usage::VectorBytes(pilots_) + memory_usage::VectorBytes(slots_);
+}
+
+// Корзины размещаются от больших к меньшим. Для корзины перебираются сдвиги, пока все её ключи не попадут
+// в свободные слоты. Последним корзинам остаётся мало свободных слотов, для одиночного ключа при k свободных
+// из n нужно в среднем n / k проб, поэтому в сумме ожидается порядка n * ln(n) проб (на именах остановок
+// от 10^3 до 10^6 ключей — около 4 * n * ln(n), 1,4 с на 10^6 ключей). Бюджет попытки 16 * n * log2(n) —
+// с запасом от ожидаемого, чтобы неудачный набор ключей не строился за O(n^2)
+bool PerfectHash::TryBuild(const std::vector<uint64_t>& hashes, const std::vector<uint32_t>& values,
+                           size_t bucket_count) {
+    const size_t key_count = hashes.size();
+    const uint64_t max_pilot = std::max<uint64_t>(1 << 16, key_count * 64);
+    uint64_t log_key_count = 1;
+    while ((uint64_t{1} << log_key_count) < key_count) {
+        ++log_key_count;
+    }
+    uint64_t tries_left = std::max<uint64_t>(1 << 20, 16 * key_count * log_key_count);
+
+    pilots_.assign(bucket_count, 0);
+    slots_.assign(key_count, NPOS);
+
+    std::vector<std::vector<size_t>> buckets(bucket_count);
+    for (size_t i = 0; i < key_count; ++i) {
+        buckets[BucketOf(hashes[i])].push_back(i);
+    }
+    std::vector<size_t> bucket_order(bucket_count);
+    std::iota(bucket_order.begin(), bucket_order.end(), 0);
+    std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                     [&buckets](size_t lhs, size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+    std::vector<bool> taken(key_count, false);
+    std::vector<size_t> candidate_slots;
+    for (const size_t bucket : bucket_order) {
+        const std::vector<size_t>& bucket_keys = buckets[bucket];
+        if (bucket_keys.empty()) {
+            break;
+        }
+        bool placed = false;
+        for (uint64_t pilot = 0; pilot < max_pilot && !placed; ++pilot) {
+            if (tries_left-- == 0) {
+                return false;
+            }
+            candidate_slots.clear();
+            placed = true;
+            for (const size_t key : bucket_keys) {
+                const size_t slot = SlotOf(hashes[key], static_cast<uint32_t>(pilot));
+                if (taken[slot]) {
+                    placed = false;
+                    break;
+                }
+                taken[slot] = true;
+                candidate_slots.push_back(slot);
+            }
+            if (!placed) {
+                for (const size_t slot : candidate_slots) {
+                    taken[slot] = false;
+                }
+                continue;
+            }
+            pilots_[bucket] = static_cast<uint32_t>(pilot);
+            for (size_t i = 0; i < bucket_keys.size(); ++i) {
+                slots_[candidate_slots[i]] = values[bucket_keys[i]];
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PerfectHash::BucketOf(uint64_t hash) const { return (hash >> 32) % pilots_.size(); }
+
+size_t PerfectHash::SlotOf(uint64_t hash, uint32_t pilot) const {
+    return detail::Mix(hash + pilot * 0x9e3779b97f4a7c15ULL) % slots_.size();
+}
+
+}  // namespace perfect_hash
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace perfect_hash {
+
+// Минимальная совершенная хеш-функция над неизменяемым набором строковых ключей (схема "hash and displace").
+// Каждый ключ хешируется один раз: старшие биты хеша выбирают корзину, сдвиг (pilot) корзины
+// переводит хеш в единственный слот таблицы, в слоте хранится значение ключа.
+// Find не сравнивает строки: для ключа вне набора возвращается значение произвольного ключа,
+// проверка совпадения остаётся на вызывающей стороне.
+class PerfectHash {
+   public:
+    static constexpr uint32_t NPOS = std::numeric_limits<uint32_t>::max();
+
+    PerfectHash() = default;
+
+    // Ключи должны быть уникальными, values[i] — значение ключа keys[i]. Если функцию построить не удалось,
+    // в том числе из-за повторяющихся ключей, объект остаётся пустым (Empty)
+    PerfectHash(const std::vector<std::string_view>& keys, const std::vector<uint32_t>& values);
+
+    PerfectHash(uint64_t seed, std::vector<uint32_t> pilots, std::vector<uint32_t> slots);
+
+    uint32_t Find(std::string_view key) const;
+
+    bool Empty() const;
+
+    uint64_t GetSeed() const;
+
+    const std::vector<uint32_t>& GetPilots() const;
+
+    const std::vector<uint32_t>& GetSlots() const;
+
+    size_t MemoryUsage() const;
+
+   private:
+    uint64_t seed_ = 0;
+    std::vector<uint32_t> pilots_;
+    std::vector<uint32_t> slots_;
+
+    bool TryBuild(const std::vector<uint64_t>& hashes, const std::vector<uint32_t>& values, size_t bucket_count);
+
+    size_t BucketOf(uint64_t hash) const;
+
+    size_t SlotOf(uint64_t hash, uint32_t pilot) const;
+};
+
+namespace detail {
+
+uint64_t HashString(std::string_view str, uint64_t seed);
+
+uint64_t Mix(uint64_t value);
+
+}  // namespace detail
+
+}  // namespace perfect_hash
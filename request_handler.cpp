@@ -10,13 +10,17 @@ void RequestHandler::AddStop(const StopBaseRequest& stop_base_request) {
 }
 
 void RequestHandler::AddBus(const BusBaseRequest& bus_base_request) {
+    using namespace std::literals;
     domain::Bus new_bus;
     new_bus.name = bus_base_request.name;
     new_bus.is_roundtrip = bus_base_request.is_roundtrip;
+    new_bus.route.reserve(bus_base_request.route.size());
     for (std::string_view stop_name : bus_base_request.route) {
         const domain::Stop* stop = db_.FindStop(stop_name);
-        new_bus.unique_stops.insert(stop);
-        new_bus.route.push_back(stop);
+        if (!stop) {
+            throw std::invalid_argument("Cannot add bus. Stop not found"s);
+        }
+        new_bus.route.push_back(stop->id);
     }
     db_.AddRoute(new_bus);
 }
@@ -27,6 +31,37 @@ void RequestHandler::SetDistance(std::string_view from, std::string_view dest, i
     db_.SetDistance(db_.FindStop(from), db_.FindStop(dest), distance);
 }
 
+void RequestHandler::RestoreBus(const transport_routine::domain::Bus& bus, const domain::RouteStats& stats) {
+    db_.RestoreRoute(bus, stats);
+}
+
+void RequestHandler::RestoreBusesByStop(std::string_view stop_name, const std::vector<const domain::Bus*>& buses) {
+    db_.RestoreStopUniqueBuses(db_.FindStop(stop_name), buses);
+}
+
+void RequestHandler::BeginBulkLoad() { db_.BeginBulkLoad(); }
+
+void RequestHandler::EndBulkLoad() { db_.EndBulkLoad(); }
+
+void RequestHandler::BuildNameIndex() { db_.BuildNameIndex(); }
+
+void RequestHandler::BuildPrefixIndex() { db_.BuildPrefixIndex(); }
+
+void RequestHandler::SetPrefixIndex(std::vector<uint32_t> stops_by_name, std::vector<uint32_t> routes_by_name) {
+    db_.SetPrefixIndex(std::move(stops_by_name), std::move(routes_by_name));
+}
+
+void RequestHandler::BuildSpatialIndex() { db_.BuildSpatialIndex(); }
+
+void RequestHandler::BuildMembershipIndex() { db_.BuildMembershipIndex(); }
+
+void RequestHandler::SetSpatialIndex(spatial_index::GeoGrid stop_grid) { db_.SetSpatialIndex(std::move(stop_grid)); }
+
+void RequestHandler::SetNameIndex(perfect_hash::PerfectHash stop_name_index,
+                                  perfect_hash::PerfectHash route_name_index) {
+    db_.SetNameIndex(std::move(stop_name_index), std::move(route_name_index));
+}
+
 const domain::RouteStats* RequestHandler::GetBusStat(std::string_view bus_name) const {
     return db_.FindRouteStats(bus_name);
 }
@@ -35,6 +70,29 @@ const std::set<std::string_view>* RequestHandler::GetBusesByStop(std::string_vie
     return db_.FindStopUniqueBuses(stop_name);
 }
 
+std::vector<std::string_view> RequestHandler::SuggestStops(std::string_view prefix, size_t limit) const {
+    return db_.SuggestStops(prefix, limit);
+}
+
+std::vector<std::string_view> RequestHandler::SuggestBuses(std::string_view prefix, size_t limit) const {
+    return db_.SuggestRoutes(prefix, limit);
+}
+
+std::optional<std::vector<std::string_view>> RequestHandler::GetCommonBuses(
+    const std::vector<std::string>& stops) const {
+    return db_.FindCommonRoutes(stops);
+}
+
+std::optional<std::vector<std::string_view>> RequestHandler::GetStopsOfBuses(
+    const std::vector<std::string>& buses) const {
+    return db_.FindStopsOfRoutes(buses);
+}
+
+std::vector<spatial_index::Neighbour> RequestHandler::GetNearbyStops(geo::Coordinates point, double radius,
+                                                                     size_t count) const {
+    return db_.FindNearbyStops(point, radius, count);
+}
+
 map_renderer::SortedRoutes RequestHandler::GetAllBuses() const {
     map_renderer::SortedRoutes ret;
 
@@ -63,6 +121,30 @@ transport_router::Route RequestHandler::GetRoute(std::string_view from, std::str
     return router_->GetRoute(from, to);
 }
 
+std::optional<std::vector<transport_router::ReachableStop>> RequestHandler::GetReachableStops(
+    std::string_view from, double max_time) const {
+    using namespace std::literals;
+    if (!router_) {
+        throw std::logic_error("No router found"s);
+    }
+    return router_->GetReachableStops(from, max_time);
+}
+
+std::vector<std::vector<std::optional<double>>> RequestHandler::GetTravelTimes(
+    const std::vector<std::string>& from, const std::vector<std::string>& to) const {
+    using namespace std::literals;
+    if (!router_) {
+        throw std::logic_error("No router found"s);
+    }
+    return router_->GetTravelTimes(from, to);
+}
+
+memory_usage::MemoryReport RequestHandler::GetCatalogueMemoryUsage() const { return db_.MemoryUsage(); }
+
+memory_usage::MemoryReport RequestHandler::GetRouterMemoryUsage() const {
+    return router_ ? router_->MemoryUsage() : memory_usage::MemoryReport{};
+}
+
 const transport_router::TransportRouter& RequestHandler::GetTransportRouter() const {
     using namespace std::literals;
     if (!router_) {
@@ -71,7 +153,53 @@ const transport_router::TransportRouter& RequestHandler::GetTransportRouter() co
     return *router_;
 }
 
-svg::Document RequestHandler::RenderRouteMap() const { return renderer_.RenderRouteMap(GetAllBuses()); }
+StopStatRequest::Response RequestHandler::Execute(const StopStatRequest& request) const {
+    return GetBusesByStop(request.name);
+}
+
+BusStatRequest::Response RequestHandler::Execute(const BusStatRequest& request) const {
+    return GetBusStat(request.name);
+}
+
+MapRequest::Response RequestHandler::Execute(const MapRequest&) const { return RenderRouteMap(); }
+
+StatsRequest::Response RequestHandler::Execute(const StatsRequest&) const {
+    return {GetCatalogueMemoryUsage(), GetRouterMemoryUsage()};
+}
+
+RouteRequest::Response RequestHandler::Execute(const RouteRequest& request) const {
+    return GetRoute(request.from, request.to);
+}
+
+NearbyStopsRequest::Response RequestHandler::Execute(const NearbyStopsRequest& request) const {
+    return GetNearbyStops(request.point, request.radius, request.count);
+}
+
+IsochroneRequest::Response RequestHandler::Execute(const IsochroneRequest& request) const {
+    return GetReachableStops(request.from, request.max_time);
+}
+
+MatrixRequest::Response RequestHandler::Execute(const MatrixRequest& request) const {
+    return GetTravelTimes(request.origins, request.destinations);
+}
+
+SuggestRequest::Response RequestHandler::Execute(const SuggestRequest& request) const {
+    return {SuggestStops(request.prefix, request.limit), SuggestBuses(request.prefix, request.limit)};
+}
+
+CommonBusesRequest::Response RequestHandler::Execute(const CommonBusesRequest& request) const {
+    return GetCommonBuses(request.stops);
+}
+
+StopsOfBusesRequest::Response RequestHandler::Execute(const StopsOfBusesRequest& request) const {
+    return GetStopsOfBuses(request.buses);
+}
+
+svg::Document RequestHandler::RenderRouteMap() const {
+    static const std::deque<domain::Stop> NO_STOPS;
+    const std::deque<domain::Stop>* stops = db_.GetAllStops();
+    return renderer_.RenderRouteMap(GetAllBuses(), stops ? *stops : NO_STOPS);
+}
 
 const catalogue::TransportCatalogue& RequestHandler::GetCatalogue() const { return db_; }
 
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <map>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "map_renderer.h"
+#include "memory_usage.h"
+#include "perfect_hash.h"
 #include "svg.h"
 #include "transport_catalogue.h"
 #include "transport_router.h"
@@ -26,52 +31,102 @@ struct BusBaseRequest {
     bool is_roundtrip = false;
 };
 
-class StatRequest {
-   protected:
-    StatRequest(int id, std::string type) : id_(id), type_(std::move(type)) {}
+// Запросы к базе. Response — тип ответа на запрос, который возвращает RequestHandler::Execute
+struct StopStatRequest {
+    using Response = const std::set<std::string_view>*;  // nullptr — остановка не найдена
 
-   public:
-    virtual ~StatRequest() = default;
+    int id = 0;
+    std::string name;
+};
+
+struct BusStatRequest {
+    using Response = const domain::RouteStats*;  // nullptr — маршрут не найден
 
-    virtual int GetId() const { return id_; }
+    int id = 0;
+    std::string name;
+};
 
-    virtual const std::string& GetType() const { return type_; }
+struct MapRequest {
+    using Response = svg::Document;
 
-   protected:
-    int id_ = 0;
-    std::string type_;
+    int id = 0;
 };
 
-class BusStopStatRequest final : public StatRequest {
-   public:
-    BusStopStatRequest(int id, std::string type, std::string name)
-        : StatRequest(id, std::move(type)), name_(std::move(name)) {}
+struct StatsRequest {
+    struct Response {
+        memory_usage::MemoryReport catalogue;
+        memory_usage::MemoryReport router;
+    };
 
-    const std::string& GetName() const { return name_; }
+    int id = 0;
+};
 
-   private:
-    std::string name_;
+struct RouteRequest {
+    using Response = transport_router::Route;
+
+    int id = 0;
+    std::string from;
+    std::string to;
 };
 
-class MapRequest final : public StatRequest {
-   public:
-    MapRequest(int id, std::string type) : StatRequest(id, std::move(type)) {}
+struct NearbyStopsRequest {
+    using Response = std::vector<spatial_index::Neighbour>;
+
+    int id = 0;
+    geo::Coordinates point;
+    double radius = .0;
+    size_t count = 0;
 };
 
-class RouteRequest final : public StatRequest {
-   public:
-    RouteRequest(int id, std::string type, std::string from, std::string to)
-        : StatRequest(id, std::move(type)), from_(std::move(from)), to_(std::move(to)) {}
+struct IsochroneRequest {
+    using Response = std::optional<std::vector<transport_router::ReachableStop>>;
 
-    const std::string& GetFrom() const { return from_; }
+    int id = 0;
+    std::string from;
+    double max_time = .0;
+};
 
-    const std::string& GetTo() const { return to_; }
+struct MatrixRequest {
+    using Response = std::vector<std::vector<std::optional<double>>>;
 
-   private:
-    std::string from_;
-    std::string to_;
+    int id = 0;
+    std::vector<std::string> origins;
+    std::vector<std::string> destinations;
 };
 
+struct SuggestRequest {
+    struct Response {
+        std::vector<std::string_view> stops;
+        std::vector<std::string_view> buses;
+    };
+
+    int id = 0;
+    std::string prefix;
+    size_t limit = 0;
+};
+
+struct CommonBusesRequest {
+    using Response = std::optional<std::vector<std::string_view>>;
+
+    int id = 0;
+    std::vector<std::string> stops;
+};
+
+struct StopsOfBusesRequest {
+    using Response = std::optional<std::vector<std::string_view>>;
+
+    int id = 0;
+    std::vector<std::string> buses;
+};
+
+using StatRequest = std::variant<StopStatRequest, BusStatRequest, MapRequest, StatsRequest, RouteRequest,
+                                 NearbyStopsRequest, IsochroneRequest, MatrixRequest, SuggestRequest,
+                                 CommonBusesRequest, StopsOfBusesRequest>;
+
+inline int GetRequestId(const StatRequest& request) {
+    return std::visit([](const auto& typed_request) { return typed_request.id; }, request);
+}
+
 class RequestHandler {
    public:
     explicit RequestHandler(catalogue::TransportCatalogue& db, map_renderer::MapRenderer& renderer);
@@ -84,10 +139,42 @@ class RequestHandler {
 
     void SetDistance(std::string_view from, std::string_view dest, int distance);
 
+    void RestoreBus(const transport_routine::domain::Bus& bus, const domain::RouteStats& stats);
+
+    void RestoreBusesByStop(std::string_view stop_name, const std::vector<const domain::Bus*>& buses);
+
+    void BeginBulkLoad();
+
+    void EndBulkLoad();
+
+    void BuildNameIndex();
+
+    void BuildPrefixIndex();
+
+    void SetPrefixIndex(std::vector<uint32_t> stops_by_name, std::vector<uint32_t> routes_by_name);
+
+    void BuildSpatialIndex();
+
+    void BuildMembershipIndex();
+
+    void SetSpatialIndex(spatial_index::GeoGrid stop_grid);
+
+    void SetNameIndex(perfect_hash::PerfectHash stop_name_index, perfect_hash::PerfectHash route_name_index);
+
     const domain::RouteStats* GetBusStat(std::string_view bus_name) const;
 
     const std::set<std::string_view>* GetBusesByStop(std::string_view stop_name) const;
 
+    std::vector<std::string_view> SuggestStops(std::string_view prefix, size_t limit) const;
+
+    std::vector<std::string_view> SuggestBuses(std::string_view prefix, size_t limit) const;
+
+    std::optional<std::vector<std::string_view>> GetCommonBuses(const std::vector<std::string>& stops) const;
+
+    std::optional<std::vector<std::string_view>> GetStopsOfBuses(const std::vector<std::string>& buses) const;
+
+    std::vector<spatial_index::Neighbour> GetNearbyStops(geo::Coordinates point, double radius, size_t count) const;
+
     map_renderer::SortedRoutes GetAllBuses() const;
 
     void SetRenderSettings(const map_renderer::RenderSettings& render_settings);
@@ -98,8 +185,51 @@ class RequestHandler {
 
     transport_router::Route GetRoute(std::string_view from, std::string_view to) const;
 
+    std::optional<std::vector<transport_router::ReachableStop>> GetReachableStops(std::string_view from,
+                                                                                  double max_time) const;
+
+    std::vector<std::vector<std::optional<double>>> GetTravelTimes(const std::vector<std::string>& from,
+                                                                   const std::vector<std::string>& to) const;
+
     const transport_router::TransportRouter& GetTransportRouter() const;
 
+    StopStatRequest::Response Execute(const StopStatRequest& request) const;
+
+    BusStatRequest::Response Execute(const BusStatRequest& request) const;
+
+    MapRequest::Response Execute(const MapRequest& request) const;
+
+    StatsRequest::Response Execute(const StatsRequest& request) const;
+
+    RouteRequest::Response Execute(const RouteRequest& request) const;
+
+    NearbyStopsRequest::Response Execute(const NearbyStopsRequest& request) const;
+
+    IsochroneRequest::Response Execute(const IsochroneRequest& request) const;
+
+    MatrixRequest::Response Execute(const MatrixRequest& request) const;
+
+    SuggestRequest::Response Execute(const SuggestRequest& request) const;
+
+    CommonBusesRequest::Response Execute(const CommonBusesRequest& request) const;
+
+    StopsOfBusesRequest::Response Execute(const StopsOfBusesRequest& request) const;
+
+    // Выполняет запросы по порядку и для каждого вызывает on_response(запрос, ответ) с запросом конкретного типа.
+    // Запросы только читают базу и не зависят друг от друга
+    template <typename ResponseHandler>
+    void ExecuteStatRequests(const std::vector<StatRequest>& requests, ResponseHandler&& on_response) const;
+
+    // То же для запросов с номерами [first, last). Диапазоны можно выполнять в разных потоках
+    template <typename ResponseHandler>
+    void ExecuteStatRequests(const std::vector<StatRequest>& requests, size_t first, size_t last,
+                             ResponseHandler&& on_response) const;
+
+    memory_usage::MemoryReport GetCatalogueMemoryUsage() const;
+
+    // Пустой отчёт, если маршрутизатор не построен
+    memory_usage::MemoryReport GetRouterMemoryUsage() const;
+
     const catalogue::TransportCatalogue& GetCatalogue() const;
 
     const map_renderer::RenderSettings& GetRenderSettings() const;
@@ -110,4 +240,20 @@ class RequestHandler {
     std::unique_ptr<transport_router::TransportRouter> router_;
 };
 
+template <typename ResponseHandler>
+void RequestHandler::ExecuteStatRequests(const std::vector<StatRequest>& requests,
+                                         ResponseHandler&& on_response) const {
+    ExecuteStatRequests(requests, 0, requests.size(), std::forward<ResponseHandler>(on_response));
+}
+
+template <typename ResponseHandler>
+void RequestHandler::ExecuteStatRequests(const std::vector<StatRequest>& requests, size_t first, size_t last,
+                                         ResponseHandler&& on_response) const {
+    for (size_t i = first; i < last; ++i) {
+        std::visit(
+            [this, &on_response](const auto& typed_request) { on_response(typed_request, Execute(typed_request)); },
+            requests[i]);
+    }
+}
+
 }  // namespace transport_routine::request_handler
\ No newline at end of file
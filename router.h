@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "graph.h"
+#include "memory_usage.h"
 
 namespace graph {
 
@@ -39,6 +40,8 @@ class Router {
 
     const RoutesInternalData& GetRoutesInternalData() const;
 
+    memory_usage::MemoryReport MemoryUsage() const;
+
    private:
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
@@ -122,4 +125,15 @@ const typename Router<Weight>::RoutesInternalData& Router<Weight>::GetRoutesInte
     return routes_internal_data_;
 }
 
+template <typename Weight>
+memory_usage::MemoryReport Router<Weight>::MemoryUsage() const {
+    memory_usage::MemoryReport ret;
+    size_t table_bytes = memory_usage::VectorBytes(routes_internal_data_);
+    for (const auto& row : routes_internal_data_) {
+        table_bytes += memory_usage::VectorBytes(row);
+    }
+    ret.Add("routes_internal_data", table_bytes);
+    return ret;
+}
+
 }  // namespace graph
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "serialization.h"
 
 #include <fstream>
+#include <stdexcept>
 #include <string_view>
 #include <unordered_map>
 
@@ -361,51 +362,133 @@ transport_catalogue_serialize::Stop SerializeStop(
     return ret;
 }
 
-transport_catalogue_serialize::Bus SerializeBus(const transport_routine::domain::Bus& bus) {
+transport_catalogue_serialize::RouteStats SerializeRouteStats(const transport_routine::domain::RouteStats& stats) {
+    transport_catalogue_serialize::RouteStats ret;
+    ret.set_route_length(stats.total_distance);
+    ret.set_stop_count(stats.total_stops);
+    ret.set_unique_stop_count(stats.unique_stops);
+    ret.set_curvature(stats.curvature);
+    return ret;
+}
+
+transport_routine::domain::RouteStats DeserializeRouteStats(const transport_catalogue_serialize::RouteStats& stats) {
+    return {stats.route_length(), stats.stop_count(), stats.unique_stop_count(), stats.curvature()};
+}
+
+transport_catalogue_serialize::Bus SerializeBus(const transport_routine::domain::Bus& bus,
+                                                const transport_routine::domain::RouteStats* stats) {
     transport_catalogue_serialize::Bus ret;
     ret.set_name(bus.name);
     if (!bus.route.empty()) {
-        for (const transport_routine::domain::Stop* stop_ptr : bus.route) {
-            ret.add_route(stop_ptr->name);
-        }
+        ret.mutable_stops()->Add(bus.route.begin(), bus.route.end());
     }
     ret.set_is_roundtrip(bus.is_roundtrip);
+    if (stats) {
+        *ret.mutable_stats() = SerializeRouteStats(*stats);
+    }
     return ret;
 }
 
 transport_routine::domain::Bus DeserializeBus(const transport_routine::catalogue::TransportCatalogue& catalogue,
                                               const transport_catalogue_serialize::Bus& bus) {
     transport_routine::domain::Bus ret;
+    using namespace std::literals;
     ret.name = bus.name();
-    if (bus.route_size() != 0) {
+    if (bus.stops_size() != 0) {
+        ret.route.reserve(bus.stops_size());
+        for (const uint32_t stop_id : bus.stops()) {
+            ret.route.push_back(catalogue.GetStop(stop_id).id);
+        }
+    } else if (bus.route_size() != 0) {
         for (const std::string& stop : bus.route()) {
             const transport_routine::domain::Stop* stop_ptr = catalogue.FindStop(stop);
-            ret.unique_stops.insert(stop_ptr);
-            ret.route.push_back(stop_ptr);
+            if (!stop_ptr) {
+                throw std::invalid_argument("Cannot deserialize bus. Stop not found"s);
+            }
+            ret.route.push_back(stop_ptr->id);
         }
     }
     ret.is_roundtrip = bus.is_roundtrip();
     return ret;
 }
 
+transport_catalogue_serialize::PerfectHash SerializePerfectHash(const perfect_hash::PerfectHash& perfect_hash) {
+    transport_catalogue_serialize::PerfectHash ret;
+    ret.set_seed(perfect_hash.GetSeed());
+    ret.mutable_pilots()->Add(perfect_hash.GetPilots().begin(), perfect_hash.GetPilots().end());
+    ret.mutable_slots()->Add(perfect_hash.GetSlots().begin(), perfect_hash.GetSlots().end());
+    return ret;
+}
+
+perfect_hash::PerfectHash DeserializePerfectHash(const transport_catalogue_serialize::PerfectHash& perfect_hash) {
+    return {perfect_hash.seed(),
+            {perfect_hash.pilots().begin(), perfect_hash.pilots().end()},
+            {perfect_hash.slots().begin(), perfect_hash.slots().end()}};
+}
+
+transport_catalogue_serialize::GeoGrid SerializeGeoGrid(const spatial_index::GeoGrid& grid) {
+    transport_catalogue_serialize::GeoGrid ret;
+    const spatial_index::GridBounds& bounds = grid.GetBounds();
+    ret.set_min_lat(bounds.min_lat);
+    ret.set_min_lng(bounds.min_lng);
+    ret.set_cell_lat(bounds.cell_lat);
+    ret.set_cell_lng(bounds.cell_lng);
+    ret.set_rows(bounds.rows);
+    ret.set_cols(bounds.cols);
+    ret.mutable_cell_offsets()->Add(grid.GetCellOffsets().begin(), grid.GetCellOffsets().end());
+    ret.mutable_ids()->Add(grid.GetIds().begin(), grid.GetIds().end());
+    return ret;
+}
+
+spatial_index::GeoGrid DeserializeGeoGrid(const transport_routine::catalogue::TransportCatalogue& catalogue,
+                                          const transport_catalogue_serialize::GeoGrid& grid) {
+    std::vector<geo::Coordinates> points;
+    if (const auto* all_stops_ptr = catalogue.GetAllStops()) {
+        for (const transport_routine::domain::Stop& stop : *all_stops_ptr) {
+            points.push_back(stop.point);
+        }
+    }
+    spatial_index::GridBounds bounds{grid.min_lat(),  grid.min_lng(), grid.cell_lat(),
+                                     grid.cell_lng(), grid.rows(),    grid.cols()};
+    return {bounds,
+            {grid.cell_offsets().begin(), grid.cell_offsets().end()},
+            {grid.ids().begin(), grid.ids().end()},
+            points};
+}
+
 transport_catalogue_serialize::TransportCatalogue SerializeBase(
     const transport_routine::catalogue::TransportCatalogue& catalogue,
     const transport_router::TransportRouter& transport_router, const map_renderer::RenderSettings& render_settings) {
     transport_catalogue_serialize::TransportCatalogue ret;
+    std::unordered_map<std::string_view, uint32_t> route_indexes;
+    const auto* all_routes_ptr = catalogue.GetAllRoutes();
+    if (all_routes_ptr) {
+        for (const transport_routine::domain::Bus& bus : *all_routes_ptr) {
+            route_indexes.insert({bus.name, static_cast<uint32_t>(ret.base().routes_size())});
+            *ret.mutable_base()->add_routes() = SerializeBus(bus, catalogue.FindRouteStats(bus.name));
+        }
+    }
     const auto* all_stops_ptr = catalogue.GetAllStops();
     if (all_stops_ptr) {
         for (const transport_routine::domain::Stop& stop : *all_stops_ptr) {
             const std::unordered_map<const transport_routine::domain::Stop*, int>* stop_distances =
                 catalogue.GetStopDistances(&stop);
-            *ret.mutable_base()->add_stops() = SerializeStop(stop, stop_distances);
-        }
-    }
-    const auto* all_routes_ptr = catalogue.GetAllRoutes();
-    if (all_routes_ptr) {
-        for (const transport_routine::domain::Bus& bus : *all_routes_ptr) {
-            *ret.mutable_base()->add_routes() = SerializeBus(bus);
+            transport_catalogue_serialize::Stop* stop_ptr = ret.mutable_base()->add_stops();
+            *stop_ptr = SerializeStop(stop, stop_distances);
+            if (const std::set<std::string_view>* buses = catalogue.FindStopUniqueBuses(stop.name)) {
+                for (std::string_view bus_name : *buses) {
+                    stop_ptr->add_buses(route_indexes.at(bus_name));
+                }
+            }
         }
     }
+    *ret.mutable_base()->mutable_stop_name_index() = SerializePerfectHash(catalogue.GetStopNameIndex());
+    *ret.mutable_base()->mutable_route_name_index() = SerializePerfectHash(catalogue.GetRouteNameIndex());
+    *ret.mutable_base()->mutable_stop_grid() = SerializeGeoGrid(catalogue.GetSpatialIndex());
+    ret.mutable_base()->mutable_stops_by_name()->Add(catalogue.GetStopsByName().begin(),
+                                                     catalogue.GetStopsByName().end());
+    ret.mutable_base()->mutable_routes_by_name()->Add(catalogue.GetRoutesByName().begin(),
+                                                      catalogue.GetRoutesByName().end());
     *ret.mutable_map_renderer()->mutable_render_settings() = SerializeRenderSettings(render_settings);
     *ret.mutable_transport_router()->mutable_routing_settings() =
         SerializeRoutingSettings(transport_router.GetRoutingSettings());
@@ -430,9 +513,12 @@ void SerializeCatalogue(const transport_routine::request_handler::RequestHandler
 
 void DeserializeCatalogue(transport_routine::request_handler::RequestHandler& handler,
                           const SerializationSettings& settings) {
+    using namespace std::literals;
     std::ifstream file(settings.file, std::ios::binary);
     transport_catalogue_serialize::TransportCatalogue catalogue;
-    catalogue.ParseFromIstream(&file);
+    if (file && !catalogue.ParseFromIstream(&file)) {
+        throw std::invalid_argument("Cannot parse base file "s + settings.file);
+    }
 
     if (catalogue.mutable_base()->stops_size() != 0) {
         for (const transport_catalogue_serialize::Stop& stop : catalogue.mutable_base()->stops()) {
@@ -444,11 +530,45 @@ void DeserializeCatalogue(transport_routine::request_handler::RequestHandler& ha
             }
         }
     }
-    if (catalogue.mutable_base()->routes_size() != 0) {
+    if (catalogue.mutable_base()->routes_size() != 0 && catalogue.base().routes(0).has_stats()) {
+        for (const transport_catalogue_serialize::Bus& bus : catalogue.base().routes()) {
+            handler.RestoreBus(detail::DeserializeBus(handler.GetCatalogue(), bus),
+                               detail::DeserializeRouteStats(bus.stats()));
+        }
+        const std::deque<transport_routine::domain::Bus>& all_routes = *handler.GetCatalogue().GetAllRoutes();
+        std::vector<const transport_routine::domain::Bus*> stop_buses;
+        for (const transport_catalogue_serialize::Stop& stop : catalogue.base().stops()) {
+            if (stop.buses_size() == 0) {
+                continue;
+            }
+            stop_buses.clear();
+            for (const uint32_t bus_index : stop.buses()) {
+                stop_buses.push_back(&all_routes.at(bus_index));
+            }
+            handler.RestoreBusesByStop(stop.name(), stop_buses);
+        }
+    } else if (catalogue.mutable_base()->routes_size() != 0) {
+        handler.BeginBulkLoad();
         for (const transport_catalogue_serialize::Bus& bus : catalogue.mutable_base()->routes()) {
             // handler.AddBus(detail::MakeBusRequest(bus));
             handler.AddBus(detail::DeserializeBus(handler.GetCatalogue(), bus));
         }
+        handler.EndBulkLoad();
+    }
+    handler.SetNameIndex(detail::DeserializePerfectHash(catalogue.base().stop_name_index()),
+                         detail::DeserializePerfectHash(catalogue.base().route_name_index()));
+    if ((catalogue.base().stops_size() == 0 || catalogue.base().stops_by_name_size() != 0) &&
+        (catalogue.base().routes_size() == 0 || catalogue.base().routes_by_name_size() != 0)) {
+        handler.SetPrefixIndex({catalogue.base().stops_by_name().begin(), catalogue.base().stops_by_name().end()},
+                               {catalogue.base().routes_by_name().begin(), catalogue.base().routes_by_name().end()});
+    } else {
+        handler.BuildPrefixIndex();
+    }
+    handler.BuildMembershipIndex();
+    if (catalogue.base().has_stop_grid()) {
+        handler.SetSpatialIndex(detail::DeserializeGeoGrid(handler.GetCatalogue(), catalogue.base().stop_grid()));
+    } else {
+        handler.BuildSpatialIndex();
     }
 
     handler.SetRenderSettings(detail::DeserializeRenderSettings(catalogue.mutable_map_renderer()->render_settings()));
@@ -84,10 +84,21 @@ transport_catalogue_serialize::Stop SerializeStop(
     const transport_routine::domain::Stop& stop,
     const std::unordered_map<const transport_routine::domain::Stop*, int>* stop_distances);
 
-transport_catalogue_serialize::Bus SerializeBus(const transport_routine::domain::Bus& bus);
+transport_catalogue_serialize::RouteStats SerializeRouteStats(const transport_routine::domain::RouteStats& stats);
+transport_routine::domain::RouteStats DeserializeRouteStats(const transport_catalogue_serialize::RouteStats& stats);
+
+transport_catalogue_serialize::Bus SerializeBus(const transport_routine::domain::Bus& bus,
+                                                const transport_routine::domain::RouteStats* stats);
 transport_routine::domain::Bus DeserializeBus(const transport_routine::catalogue::TransportCatalogue& catalogue,
                                               const transport_catalogue_serialize::Bus& bus);
 
+transport_catalogue_serialize::PerfectHash SerializePerfectHash(const perfect_hash::PerfectHash& perfect_hash);
+perfect_hash::PerfectHash DeserializePerfectHash(const transport_catalogue_serialize::PerfectHash& perfect_hash);
+
+transport_catalogue_serialize::GeoGrid SerializeGeoGrid(const spatial_index::GeoGrid& grid);
+spatial_index::GeoGrid DeserializeGeoGrid(const transport_routine::catalogue::TransportCatalogue& catalogue,
+                                          const transport_catalogue_serialize::GeoGrid& grid);
+
 transport_catalogue_serialize::TransportCatalogue SerializeBase(
     const transport_routine::catalogue::TransportCatalogue& catalogue,
     const transport_router::TransportRouter& transport_router, const map_renderer::RenderSettings& render_settings);
@@ -97,6 +108,8 @@ transport_catalogue_serialize::TransportCatalogue SerializeBase(
 void SerializeCatalogue(const transport_routine::request_handler::RequestHandler& handler,
                         const SerializationSettings& settings);
 
+// Файл, который не удалось разобрать, — исключение invalid_argument, handler при этом может остаться заполненным
+// частично. Отсутствующий файл загружается как пустая база
 void DeserializeCatalogue(transport_routine::request_handler::RequestHandler& handler,
                           const SerializationSettings& settings);
 
@@ -0,0 +1,101 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace transport_routine::snapshot {
+
+using namespace std::literals;
+
+SnapshotStore::ReadGuard::ReadGuard(ReadGuard&& other) noexcept
+    : epoch_(std::exchange(other.epoch_, nullptr)), snapshot_(std::exchange(other.snapshot_, nullptr)) {}
+
+SnapshotStore::ReadGuard::~ReadGuard() {
+    if (epoch_) {
+        epoch_->store(0);
+    }
+}
+
+SnapshotStore::Reader::Reader(SnapshotStore& store) : store_(store) {
+    for (ReaderBlock* block = &store_.first_block_;;) {
+        for (size_t i = 0; i < READERS_PER_BLOCK; ++i) {
+            bool expected = false;
+            if (block->slots[i].compare_exchange_strong(expected, true)) {
+                epoch_ = &block->epochs[i];
+                slot_ = &block->slots[i];
+                return;
+            }
+        }
+        ReaderBlock* next = block->next.load();
+        if (!next) {
+            // Блок добавляет тот, кто первым запишет указатель, остальные переходят к его блоку
+            auto new_block = std::make_unique<ReaderBlock>();
+            if (block->next.compare_exchange_strong(next, new_block.get())) {
+                next = new_block.release();
+            }
+        }
+        block = next;
+    }
+}
+
+SnapshotStore::Reader::~Reader() {
+    epoch_->store(0);
+    slot_->store(false);
+}
+
+SnapshotStore::ReadGuard SnapshotStore::Reader::Acquire() const {
+    std::atomic<uint64_t>& epoch = *epoch_;
+    if (epoch.load() != 0) {
+        throw std::logic_error("Snapshot reader already holds a version"s);
+    }
+    // Эпоха записывается до чтения указателя: писатель, не увидевший её, уже подменил указатель
+    epoch.store(store_.epoch_.load());
+    return ReadGuard(&epoch, store_.current_.load());
+}
+
+SnapshotStore::~SnapshotStore() {
+    delete current_.load();
+    for (ReaderBlock* block = first_block_.next.load(); block;) {
+        delete std::exchange(block, block->next.load());
+    }
+}
+
+void SnapshotStore::Publish(std::unique_ptr<Snapshot> snapshot) {
+    std::lock_guard guard(writer_mutex_);
+    const Snapshot* previous = current_.exchange(snapshot.release());
+    const uint64_t epoch = epoch_.fetch_add(1);
+    if (previous) {
+        retired_.push_back({epoch, std::unique_ptr<const Snapshot>(previous)});
+    }
+    ReclaimLocked();
+}
+
+bool SnapshotStore::Reclaim() {
+    std::lock_guard guard(writer_mutex_);
+    return ReclaimLocked();
+}
+
+uint64_t SnapshotStore::GetEpoch() const { return epoch_.load(); }
+
+bool SnapshotStore::ReclaimLocked() {
+    uint64_t min_reader_epoch = std::numeric_limits<uint64_t>::max();
+    for (const ReaderBlock* block = &first_block_; block; block = block->next.load()) {
+        for (const std::atomic<uint64_t>& reader_epoch : block->epochs) {
+            const uint64_t epoch = reader_epoch.load();
+            if (epoch != 0) {
+                min_reader_epoch = std::min(min_reader_epoch, epoch);
+            }
+        }
+    }
+    // Версия, снятая в эпоху epoch, могла быть прочитана только читателями, вошедшими в эпохи <= epoch
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [min_reader_epoch](const RetiredSnapshot& retired) {
+                                      return retired.epoch < min_reader_epoch;
+                                  }),
+                   retired_.end());
+    return retired_.empty();
+}
+
+}  // namespace transport_routine::snapshot
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "transport_catalogue.h"
+
+namespace transport_routine::snapshot {
+
+// Версия базы: каталог, визуализатор и обработчик запросов вместе с маршрутизатором.
+// Версия заполняется писателем до публикации и после публикации только читается.
+struct Snapshot {
+    Snapshot() : handler(catalogue, renderer) {}
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    catalogue::TransportCatalogue catalogue;
+    map_renderer::MapRenderer renderer;
+    request_handler::RequestHandler handler;
+};
+
+// Публикация версий в стиле RCU. Читатель получает указатель на текущую версию без блокировок:
+// он записывает текущую эпоху в свой слот и читает указатель. Писатель атомарно подменяет указатель,
+// увеличивает эпоху и освобождает старую версию, когда ни один читатель не остался в более ранней эпохе.
+// Писатели упорядочиваются мьютексом, читатели его не захватывают.
+// Слоты читателей выделяются блоками: когда свободных слотов нет, добавляется новый блок, число читателей не ограничено.
+class SnapshotStore {
+   public:
+    static constexpr size_t READERS_PER_BLOCK = 64;
+
+    class Reader;
+
+    // Доступ к версии на время жизни объекта. У одного Reader в каждый момент может быть один ReadGuard
+    class ReadGuard {
+       public:
+        ReadGuard(ReadGuard&& other) noexcept;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+        ~ReadGuard();
+
+        // nullptr, если ни одна версия ещё не опубликована
+        const Snapshot* Get() const { return snapshot_; }
+        const Snapshot* operator->() const { return snapshot_; }
+        const Snapshot& operator*() const { return *snapshot_; }
+
+       private:
+        friend class Reader;
+
+        ReadGuard(std::atomic<uint64_t>* epoch, const Snapshot* snapshot) : epoch_(epoch), snapshot_(snapshot) {}
+
+        std::atomic<uint64_t>* epoch_ = nullptr;
+        const Snapshot* snapshot_ = nullptr;
+    };
+
+    // Слот читателя. Используется одним потоком, живёт не дольше хранилища
+    class Reader {
+       public:
+        explicit Reader(SnapshotStore& store);
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader();
+
+        ReadGuard Acquire() const;
+
+       private:
+        SnapshotStore& store_;
+        std::atomic<uint64_t>* epoch_ = nullptr;
+        std::atomic<bool>* slot_ = nullptr;
+    };
+
+    SnapshotStore() = default;
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+    // К моменту разрушения не должно остаться читателей
+    ~SnapshotStore();
+
+    // Делает snapshot текущей версией. Читатели, уже получившие предыдущую версию, дочитывают её,
+    // она освобождается при одной из следующих публикаций или при вызове Reclaim
+    void Publish(std::unique_ptr<Snapshot> snapshot);
+
+    // Освобождает снятые версии, которые больше никто не читает. true, если снятых версий не осталось
+    bool Reclaim();
+
+    // Номер текущей эпохи, увеличивается при каждой публикации
+    uint64_t GetEpoch() const;
+
+   private:
+    struct RetiredSnapshot {
+        uint64_t epoch = 0;
+        std::unique_ptr<const Snapshot> snapshot;
+    };
+
+    // Блоки слотов образуют список, который только растёт до разрушения хранилища
+    struct ReaderBlock {
+        // 0 — читатель вне критической секции, иначе эпоха, в которой он вошёл
+        std::array<std::atomic<uint64_t>, READERS_PER_BLOCK> epochs{};
+        std::array<std::atomic<bool>, READERS_PER_BLOCK> slots{};
+        std::atomic<ReaderBlock*> next{nullptr};
+    };
+
+    std::atomic<const Snapshot*> current_{nullptr};
+    std::atomic<uint64_t> epoch_{1};
+    ReaderBlock first_block_;
+
+    std::mutex writer_mutex_;
+    std::vector<RetiredSnapshot> retired_;
+
+    bool ReclaimLocked();
+};
+
+}  // namespace transport_routine::snapshot
@@ -0,0 +1,209 @@
+#define _USE_MATH_DEFINES
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "memory_usage.h"
+
+namespace spatial_index {
+
+using namespace std::literals;
+
+namespace {
+
+const double EARTH_RADIUS = 6371000;
+const double DEG_TO_RAD = M_PI / 180.;
+const size_t POINTS_PER_CELL = 2;
+
+bool NeighbourLess(const Neighbour& lhs, const Neighbour& rhs) {
+    return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.id < rhs.id);
+}
+
+}  // namespace
+
+GeoGrid::GeoGrid(const std::vector<geo::Coordinates>& points) {
+    if (points.empty()) {
+        return;
+    }
+
+    const auto [bottom_it, top_it] = std::minmax_element(
+        points.begin(), points.end(), [](geo::Coordinates lhs, geo::Coordinates rhs) { return lhs.lat < rhs.lat; });
+    const auto [left_it, right_it] = std::minmax_element(
+        points.begin(), points.end(), [](geo::Coordinates lhs, geo::Coordinates rhs) { return lhs.lng < rhs.lng; });
+
+    const double height = top_it->lat - bottom_it->lat;
+    const double width = (right_it->lng - left_it->lng) * std::cos((top_it->lat + bottom_it->lat) / 2 * DEG_TO_RAD);
+    const size_t cell_count = std::max<size_t>(1, points.size() / POINTS_PER_CELL);
+
+    size_t rows = 1;
+    if (height > 0 && width > 0) {
+        rows = std::clamp<size_t>(std::lround(std::sqrt(cell_count * height / width)), 1, cell_count);
+    } else if (height > 0) {
+        rows = cell_count;
+    }
+    const size_t cols = std::max<size_t>(1, cell_count / rows);
+
+    bounds_.min_lat = bottom_it->lat;
+    bounds_.min_lng = left_it->lng;
+    bounds_.rows = static_cast<uint32_t>(rows);
+    bounds_.cols = static_cast<uint32_t>(cols);
+    bounds_.cell_lat = (height > 0) ? height / rows : 1.;
+    bounds_.cell_lng = (right_it->lng > left_it->lng) ? (right_it->lng - left_it->lng) / cols : 1.;
+
+    std::vector<uint32_t> point_cells(points.size());
+    cell_offsets_.assign(rows * cols + 1, 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        point_cells[i] = RowOf(points[i].lat) * bounds_.cols + ColOf(points[i].lng);
+        ++cell_offsets_[point_cells[i] + 1];
+    }
+    for (size_t cell = 1; cell < cell_offsets_.size(); ++cell) {
+        cell_offsets_[cell] += cell_offsets_[cell - 1];
+    }
+
+    std::vector<uint32_t> cell_fill(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    ids_.resize(points.size());
+    points_.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const uint32_t position = cell_fill[point_cells[i]]++;
+        ids_[position] = static_cast<uint32_t>(i);
+        points_[position] = points[i];
+    }
+}
+
+GeoGrid::GeoGrid(GridBounds bounds, std::vector<uint32_t> cell_offsets, std::vector<uint32_t> ids,
+                 const std::vector<geo::Coordinates>& points)
+    : bounds_(bounds), cell_offsets_(std::move(cell_offsets)), ids_(std::move(ids)) {
+    if (ids_.empty()) {
+        return;
+    }
+    if (cell_offsets_.size() != static_cast<size_t>(bounds_.rows) * bounds_.cols + 1 ||
+        cell_offsets_.back() != ids_.size()) {
+        throw std::invalid_argument("Spatial index cells do not match grid bounds"s);
+    }
+    points_.reserve(ids_.size());
+    for (const uint32_t id : ids_) {
+        points_.push_back(points.at(id));
+    }
+}
+
+std::vector<Neighbour> GeoGrid::FindNearby(geo::Coordinates center, double radius, size_t count) const {
+    std::vector<Neighbour> result;
+    if (Empty()) {
+        return result;
+    }
+
+    const uint32_t row = RowOf(center.lat);
+    const uint32_t col = ColOf(center.lng);
+    const uint32_t max_ring = std::max(std::max(row, bounds_.rows - 1 - row), std::max(col, bounds_.cols - 1 - col));
+
+    for (uint32_t ring = 0; ring <= max_ring; ++ring) {
+        const int64_t first_row = static_cast<int64_t>(row) - ring;
+        const int64_t last_row = static_cast<int64_t>(row) + ring;
+        const int64_t first_col = static_cast<int64_t>(col) - ring;
+        const int64_t last_col = static_cast<int64_t>(col) + ring;
+        for (int64_t r = std::max<int64_t>(first_row, 0); r <= std::min<int64_t>(last_row, bounds_.rows - 1); ++r) {
+            if (r == first_row || r == last_row) {
+                for (int64_t c = std::max<int64_t>(first_col, 0); c <= std::min<int64_t>(last_col, bounds_.cols - 1);
+                     ++c) {
+                    CollectCell(static_cast<uint32_t>(r), static_cast<uint32_t>(c), center, radius, result);
+                }
+                continue;
+            }
+            if (first_col >= 0) {
+                CollectCell(static_cast<uint32_t>(r), static_cast<uint32_t>(first_col), center, radius, result);
+            }
+            if (last_col != first_col && last_col < bounds_.cols) {
+                CollectCell(static_cast<uint32_t>(r), static_cast<uint32_t>(last_col), center, radius, result);
+            }
+        }
+
+        const double lower_bound = RingLowerBound(center, row, col, ring);
+        if (lower_bound > radius) {
+            break;
+        }
+        if (count != 0 && result.size() >= count) {
+            std::nth_element(result.begin(), result.begin() + (count - 1), result.end(), NeighbourLess);
+            if (lower_bound > result[count - 1].distance) {
+                break;
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), NeighbourLess);
+    if (count != 0 && result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
+
+bool GeoGrid::Empty() const { return ids_.empty(); }
+
+const GridBounds& GeoGrid::GetBounds() const { return bounds_; }
+
+const std::vector<uint32_t>& GeoGrid::GetCellOffsets() const { return cell_offsets_; }
+
+const std::vector<uint32_t>& GeoGrid::GetIds() const { return ids_; }
+
+size_t GeoGrid::MemoryUsage() const {
+    return memory_usage::VectorBytes(cell_offsets_) + memory_usage::VectorBytes(ids_) +
+           memory_usage::VectorBytes(points_);
+}
+
+uint32_t GeoGrid::RowOf(double lat) const {
+    const double row = std::floor((lat - bounds_.min_lat) / bounds_.cell_lat);
+    return static_cast<uint32_t>(std::clamp(row, 0., static_cast<double>(bounds_.rows - 1)));
+}
+
+uint32_t GeoGrid::ColOf(double lng) const {
+    const double col = std::floor((lng - bounds_.min_lng) / bounds_.cell_lng);
+    return static_cast<uint32_t>(std::clamp(col, 0., static_cast<double>(bounds_.cols - 1)));
+}
+
+void GeoGrid::CollectCell(uint32_t row, uint32_t col, geo::Coordinates center, double radius,
+                          std::vector<Neighbour>& result) const {
+    const size_t cell = static_cast<size_t>(row) * bounds_.cols + col;
+    for (uint32_t i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; ++i) {
+        const double distance = geo::ComputeDistance(center, points_[i]);
+        if (distance <= radius) {
+            result.push_back({ids_[i], distance});
+        }
+    }
+}
+
+// Нижняя оценка расстояния от center до любой точки за пределами колец 0..ring.
+// По широте расстояние не меньше длины дуги меридиана, по долготе — не меньше
+// расстояния между точками на самой удалённой от экватора широте сетки.
+double GeoGrid::RingLowerBound(geo::Coordinates center, uint32_t row, uint32_t col, uint32_t ring) const {
+    double lat_gap = std::numeric_limits<double>::infinity();
+    if (row >= ring + 1) {
+        lat_gap = std::min(lat_gap, center.lat - (bounds_.min_lat + (row - ring) * bounds_.cell_lat));
+    }
+    if (row + ring + 1 < bounds_.rows) {
+        lat_gap = std::min(lat_gap, (bounds_.min_lat + (row + ring + 1) * bounds_.cell_lat) - center.lat);
+    }
+    double lng_gap = std::numeric_limits<double>::infinity();
+    if (col >= ring + 1) {
+        lng_gap = std::min(lng_gap, center.lng - (bounds_.min_lng + (col - ring) * bounds_.cell_lng));
+    }
+    if (col + ring + 1 < bounds_.cols) {
+        lng_gap = std::min(lng_gap, (bounds_.min_lng + (col + ring + 1) * bounds_.cell_lng) - center.lng);
+    }
+
+    const double max_lat = bounds_.min_lat + bounds_.rows * bounds_.cell_lat;
+    const double extreme_lat =
+        std::min(90., std::max({std::abs(bounds_.min_lat), std::abs(max_lat), std::abs(center.lat)}));
+    const double lat_bound = std::max(lat_gap, 0.) * DEG_TO_RAD * EARTH_RADIUS;
+    const double lng_bound =
+        std::isinf(lng_gap)
+            ? lng_gap
+            : 2 * EARTH_RADIUS *
+                  std::asin(std::cos(extreme_lat * DEG_TO_RAD) *
+                            std::sin(std::min(std::max(lng_gap, 0.) * DEG_TO_RAD, M_PI) / 2));
+    return std::min(lat_bound, lng_bound);
+}
+
+}  // namespace spatial_index
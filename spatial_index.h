@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geo.h"
+
+namespace spatial_index {
+
+struct Neighbour {
+    uint32_t id = 0;
+    double distance = .0;
+};
+
+struct GridBounds {
+    double min_lat = .0;
+    double min_lng = .0;
+    double cell_lat = 1.;
+    double cell_lng = 1.;
+    uint32_t rows = 0;
+    uint32_t cols = 0;
+};
+
+// Равномерная сетка по широте и долготе. Идентификатор точки — её индекс в исходном векторе.
+// Ячейки хранятся подряд: точки ячейки i занимают ids[cell_offsets[i] .. cell_offsets[i + 1]).
+// Переход через 180-й меридиан не поддерживается.
+class GeoGrid {
+   public:
+    GeoGrid() = default;
+
+    explicit GeoGrid(const std::vector<geo::Coordinates>& points);
+
+    GeoGrid(GridBounds bounds, std::vector<uint32_t> cell_offsets, std::vector<uint32_t> ids,
+            const std::vector<geo::Coordinates>& points);
+
+    // Точки не дальше radius метров от center, не более count штук (0 — без ограничения),
+    // упорядоченные по geo::ComputeDistance. Ячейки просматриваются кольцами от ячейки center
+    // до тех пор, пока нижняя оценка расстояния до следующего кольца не превысит радиус
+    // или расстояние до count-й найденной точки.
+    std::vector<Neighbour> FindNearby(geo::Coordinates center, double radius, size_t count) const;
+
+    bool Empty() const;
+
+    const GridBounds& GetBounds() const;
+
+    const std::vector<uint32_t>& GetCellOffsets() const;
+
+    const std::vector<uint32_t>& GetIds() const;
+
+    size_t MemoryUsage() const;
+
+   private:
+    GridBounds bounds_;
+    std::vector<uint32_t> cell_offsets_;
+    std::vector<uint32_t> ids_;
+    std::vector<geo::Coordinates> points_;
+
+    uint32_t RowOf(double lat) const;
+
+    uint32_t ColOf(double lng) const;
+
+    void CollectCell(uint32_t row, uint32_t col, geo::Coordinates center, double radius,
+                     std::vector<Neighbour>& result) const;
+
+    double RingLowerBound(geo::Coordinates center, uint32_t row, uint32_t col, uint32_t ring) const;
+};
+
+}  // namespace spatial_index
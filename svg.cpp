@@ -1,5 +1,7 @@
 #include "svg.h"
 
+#include "number_format.h"
+
 namespace svg {
 
 using namespace std::literals;
@@ -80,8 +82,13 @@ Circle& Circle::SetRadius(double radius) {
 
 void Circle::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
-    out << "<circle cx=\""sv << center_.x << "\" cy=\""sv << center_.y << "\" "sv;
-    out << "r=\""sv << radius_ << "\" "sv;
+    out << "<circle cx=\""sv;
+    number_format::WriteDouble(out, center_.x);
+    out << "\" cy=\""sv;
+    number_format::WriteDouble(out, center_.y);
+    out << "\" r=\""sv;
+    number_format::WriteDouble(out, radius_);
+    out << "\" "sv;
     RenderAttrs(out);
     out << "/>"sv;
 }
@@ -97,7 +104,9 @@ void Polyline::RenderObject(const svg::RenderContext& context) const {
     out << "<polyline points=\""sv;
     if (!points_.empty()) {
         for (auto it = points_.begin(); it != points_.end(); ++it) {
-            out << it->x << ","sv << it->y;
+            number_format::WriteDouble(out, it->x);
+            out << ","sv;
+            number_format::WriteDouble(out, it->y);
             if (!(next(it, 1) == points_.end())) {
                 out << " "sv;
             }
@@ -164,8 +173,15 @@ Text& Text::SetData(std::string data) {
 void Text::RenderObject(const svg::RenderContext& context) const {
     auto& out = context.out;
 
-    out << "<text x=\""sv << pos_.x << "\" y=\""sv << pos_.y << "\" "sv;
-    out << "dx=\""sv << offset_.x << "\" dy=\""sv << offset_.y << "\" "sv;
+    out << "<text x=\""sv;
+    number_format::WriteDouble(out, pos_.x);
+    out << "\" y=\""sv;
+    number_format::WriteDouble(out, pos_.y);
+    out << "\" dx=\""sv;
+    number_format::WriteDouble(out, offset_.x);
+    out << "\" dy=\""sv;
+    number_format::WriteDouble(out, offset_.y);
+    out << "\" "sv;
     out << "font-size=\""sv << font_size_ << "\" "sv;
     if (!font_family_.empty()) {
         out << "font-family=\""sv << font_family_ << "\" "sv;
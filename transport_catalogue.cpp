@@ -1,22 +1,86 @@
 #include "transport_catalogue.h"
 
+#include <algorithm>
+
+#include "parallel.h"
+
 using namespace std;
 
 namespace transport_routine::catalogue {
 
 void TransportCatalogue::AddStop(const domain::Stop& stop) {
-    const domain::Stop* new_stop_ptr = &stops_.emplace_back(stop);
-    name_to_stop_unique_buses_.insert({new_stop_ptr->name, {}});
-    name_to_stop_index_.insert({new_stop_ptr->name, new_stop_ptr});
+    ResetStopNameIndex();
+    domain::Stop* new_stop_ptr = &stops_.emplace_back(stop);
+    new_stop_ptr->id = static_cast<domain::StopId>(stops_.size() - 1);
+    stop_unique_buses_.emplace_back();
+    name_to_stop_index_.insert({new_stop_ptr->name, new_stop_ptr->id});
+    stop_grid_ = {};
+    stops_by_name_.clear();
+    stop_routes_ = {};
+    route_stops_ = {};
 }
 
 void TransportCatalogue::AddRoute(const domain::Bus& route) {
-    const domain::Bus* new_bus_ptr = &routes_.emplace_back(route);
-    name_to_route_stats_.insert({new_bus_ptr->name, ComputeRouteStats(new_bus_ptr)});
-    for (const domain::Stop* stop_ptr: new_bus_ptr->unique_stops) {
-        name_to_stop_unique_buses_.at(stop_ptr->name).insert(new_bus_ptr->name);
+    ResetRouteNameIndex();
+    domain::Bus* new_bus_ptr = &routes_.emplace_back(route);
+    // Число уникальных остановок нужно ComputeRouteStats, поэтому считается до статистики
+    vector<domain::StopId> unique_stops(new_bus_ptr->route.begin(), new_bus_ptr->route.end());
+    sort(unique_stops.begin(), unique_stops.end());
+    unique_stops.erase(unique(unique_stops.begin(), unique_stops.end()), unique_stops.end());
+    new_bus_ptr->unique_stop_count = static_cast<int>(unique_stops.size());
+    for (const domain::StopId stop_id: unique_stops) {
+        stop_unique_buses_.at(stop_id).insert(new_bus_ptr->name);
+    }
+    if (is_bulk_load_) {
+        route_stats_.emplace_back();
+    } else {
+        ComputeRouteDistances(*new_bus_ptr);
+        route_stats_.push_back(ComputeRouteStats(new_bus_ptr));
+    }
+    name_to_route_index_.insert({new_bus_ptr->name, routes_.size() - 1});
+    routes_by_name_.clear();
+    stop_routes_ = {};
+    route_stops_ = {};
+}
+
+void TransportCatalogue::RestoreRoute(const domain::Bus& route, const domain::RouteStats& stats) {
+    ResetRouteNameIndex();
+    domain::Bus* new_bus_ptr = &routes_.emplace_back(route);
+    new_bus_ptr->unique_stop_count = stats.unique_stops;
+    // Статистика не пересчитывается, но префиксные расстояния нужны маршрутизатору при построении графа.
+    // Остановки и расстояния между ними к этому моменту уже восстановлены
+    ComputeRouteDistances(*new_bus_ptr);
+    route_stats_.push_back(stats);
+    name_to_route_index_.insert({new_bus_ptr->name, routes_.size() - 1});
+    routes_by_name_.clear();
+    stop_routes_ = {};
+    route_stops_ = {};
+}
+
+void TransportCatalogue::RestoreStopUniqueBuses(const domain::Stop* stop, const vector<const domain::Bus*>& buses) {
+    if (!stop) {
+        throw invalid_argument("Cannot restore buses. Stop not found"s);
+    }
+    set<string_view>& stop_buses = stop_unique_buses_[FindStopIndex(stop->name)];
+    for (const domain::Bus* bus: buses) {
+        stop_buses.insert(stop_buses.end(), bus->name);
     }
-    name_to_route_index_.insert({new_bus_ptr->name, new_bus_ptr});
+}
+
+void TransportCatalogue::BeginBulkLoad() {
+    if (is_bulk_load_) {
+        return;
+    }
+    is_bulk_load_ = true;
+    bulk_load_first_route_ = routes_.size();
+}
+
+void TransportCatalogue::EndBulkLoad() {
+    if (!is_bulk_load_) {
+        return;
+    }
+    is_bulk_load_ = false;
+    ComputeRoutesParallel(bulk_load_first_route_);
 }
 
 void TransportCatalogue::SetDistance(const domain::Stop* from, const domain::Stop* dest, int distance) {
@@ -40,19 +104,27 @@ domain::Distances TransportCatalogue::GetDistance(const domain::Stop* from, cons
 }
 
 const domain::Stop* TransportCatalogue::FindStop(string_view stop_name) const {
-    return (name_to_stop_index_.count(stop_name) != 0) ? name_to_stop_index_.at(stop_name) : nullptr;
+    const size_t index = FindStopIndex(stop_name);
+    return (index != NPOS) ? &stops_[index] : nullptr;
+}
+
+const domain::Stop& TransportCatalogue::GetStop(domain::StopId stop_id) const {
+    return stops_.at(stop_id);
 }
 
 const domain::Bus* TransportCatalogue::FindRoute(string_view route_name) const {
-    return (name_to_route_index_.count(route_name) != 0) ? name_to_route_index_.at(route_name) : nullptr;
+    const size_t index = FindRouteIndex(route_name);
+    return (index != NPOS) ? &routes_[index] : nullptr;
 }
 
 const domain::RouteStats* TransportCatalogue::FindRouteStats(std::string_view route_name) const {
-    return (name_to_route_stats_.count(route_name) != 0) ? &name_to_route_stats_.at(route_name) : nullptr;
+    const size_t index = FindRouteIndex(route_name);
+    return (index != NPOS) ? &route_stats_[index] : nullptr;
 }
 
 const std::set<std::string_view>* TransportCatalogue::FindStopUniqueBuses(std::string_view stop_name) const {
-    return (name_to_stop_unique_buses_.count(stop_name) != 0) ? &name_to_stop_unique_buses_.at(stop_name) : nullptr;
+    const size_t index = FindStopIndex(stop_name);
+    return (index != NPOS) ? &stop_unique_buses_[index] : nullptr;
 }
 
 const std::deque<domain::Bus>* TransportCatalogue::GetAllRoutes() const {
@@ -66,33 +138,186 @@ const std::unordered_map<const domain::Stop*, int>* TransportCatalogue::GetStopD
     return stop_to_stop_real_distances_.count(stop) != 0 ? &stop_to_stop_real_distances_.at(stop) : nullptr;
 }
 
-TransportCatalogue::TotalDistanceCuravature
-TransportCatalogue::ComputeTotalDistanceCurvature(const domain::Bus* route) const {
-    double total_distance = .0;
-    double total_computed_distance = .0;
-    double curvature = .0;
-    deque<const domain::Stop*> route_for_processing(route->route.begin(), route->route.end());
+void TransportCatalogue::BuildNameIndex() {
+    ResetStopNameIndex();
+    ResetRouteNameIndex();
+    vector<string_view> stop_names;
+    vector<uint32_t> stop_indexes;
+    for (const auto [name, index]: name_to_stop_index_) {
+        stop_names.push_back(name);
+        stop_indexes.push_back(static_cast<uint32_t>(index));
+    }
+    vector<string_view> route_names;
+    vector<uint32_t> route_indexes;
+    for (const auto [name, index]: name_to_route_index_) {
+        route_names.push_back(name);
+        route_indexes.push_back(static_cast<uint32_t>(index));
+    }
+    stop_name_index_ = perfect_hash::PerfectHash(stop_names, stop_indexes);
+    route_name_index_ = perfect_hash::PerfectHash(route_names, route_indexes);
+    ReleaseNameMaps();
+}
 
-    if (!route->is_roundtrip) {
-        route_for_processing.insert(route_for_processing.end(), route->route.rbegin(), route->route.rend());
-    }
-
-    if (!route_for_processing.empty()) {
-        bool is_first = true;
-        const domain::Stop* from = route_for_processing[0];
-        for (const domain::Stop* stop: route_for_processing) {
-            if (is_first) {
-                is_first = false;
-                continue;
-            }
-            const domain::Distances distances = GetDistance(from, stop);
-            total_distance += distances.path_distance;
-            total_computed_distance += distances.geo_distance;
-            from = stop;
+void TransportCatalogue::SetNameIndex(perfect_hash::PerfectHash stop_name_index,
+                                      perfect_hash::PerfectHash route_name_index) {
+    ResetStopNameIndex();
+    ResetRouteNameIndex();
+    stop_name_index_ = std::move(stop_name_index);
+    route_name_index_ = std::move(route_name_index);
+    ReleaseNameMaps();
+}
+
+// Пока индекс построен, поиск по имени идёт только через него, и хеш-таблица не хранится.
+// Если индекс построить не удалось, таблица остаётся для поиска
+void TransportCatalogue::ReleaseNameMaps() {
+    if (!stop_name_index_.Empty()) {
+        unordered_map<string_view, size_t>().swap(name_to_stop_index_);
+    }
+    if (!route_name_index_.Empty()) {
+        unordered_map<string_view, size_t>().swap(name_to_route_index_);
+    }
+}
+
+// Перед добавлением индекс сбрасывается, а освобождённая при его построении таблица восстанавливается
+void TransportCatalogue::ResetStopNameIndex() {
+    if (stop_name_index_.Empty()) {
+        return;
+    }
+    stop_name_index_ = {};
+    name_to_stop_index_.reserve(stops_.size());
+    for (const domain::Stop& stop: stops_) {
+        name_to_stop_index_.insert({stop.name, stop.id});
+    }
+}
+
+void TransportCatalogue::ResetRouteNameIndex() {
+    if (route_name_index_.Empty()) {
+        return;
+    }
+    route_name_index_ = {};
+    name_to_route_index_.reserve(routes_.size());
+    for (size_t i = 0; i < routes_.size(); ++i) {
+        name_to_route_index_.insert({routes_[i].name, i});
+    }
+}
+
+const perfect_hash::PerfectHash& TransportCatalogue::GetStopNameIndex() const {
+    return stop_name_index_;
+}
+
+const perfect_hash::PerfectHash& TransportCatalogue::GetRouteNameIndex() const {
+    return route_name_index_;
+}
+
+void TransportCatalogue::BuildPrefixIndex() {
+    stops_by_name_ = SortByName(stops_);
+    routes_by_name_ = SortByName(routes_);
+}
+
+void TransportCatalogue::SetPrefixIndex(vector<uint32_t> stops_by_name, vector<uint32_t> routes_by_name) {
+    stops_by_name_ = std::move(stops_by_name);
+    routes_by_name_ = std::move(routes_by_name);
+}
+
+const vector<uint32_t>& TransportCatalogue::GetStopsByName() const {
+    return stops_by_name_;
+}
+
+const vector<uint32_t>& TransportCatalogue::GetRoutesByName() const {
+    return routes_by_name_;
+}
+
+vector<string_view> TransportCatalogue::SuggestStops(string_view prefix, size_t limit) const {
+    return FindByPrefix(stops_, stops_by_name_, prefix, limit);
+}
+
+vector<string_view> TransportCatalogue::SuggestRoutes(string_view prefix, size_t limit) const {
+    return FindByPrefix(routes_, routes_by_name_, prefix, limit);
+}
+
+void TransportCatalogue::BuildMembershipIndex() {
+    stop_routes_ = bitset_index::BitMatrix(stops_.size(), routes_.size());
+    route_stops_ = bitset_index::BitMatrix(routes_.size(), stops_.size());
+    for (size_t route_index = 0; route_index < routes_.size(); ++route_index) {
+        for (const domain::StopId stop_id: routes_[route_index].route) {
+            stop_routes_.Set(stop_id, route_index);
+            route_stops_.Set(route_index, stop_id);
         }
-        curvature = (total_computed_distance != 0) ? total_distance / total_computed_distance : 0;
     }
+}
+
+optional<vector<string_view>> TransportCatalogue::FindCommonRoutes(const vector<string>& stop_names) const {
+    vector<size_t> stop_indexes;
+    stop_indexes.reserve(stop_names.size());
+    for (const string& name: stop_names) {
+        const size_t index = FindStopIndex(name);
+        if (index == NPOS) {
+            return nullopt;
+        }
+        stop_indexes.push_back(index);
+    }
+    vector<string_view> ret;
+    if (stop_routes_.Empty()) {
+        return ret;
+    }
+    for (const uint32_t route_index: bitset_index::SetBits(stop_routes_.AndRows(stop_indexes))) {
+        ret.push_back(routes_[route_index].name);
+    }
+    sort(ret.begin(), ret.end());
+    return ret;
+}
+
+optional<vector<string_view>> TransportCatalogue::FindStopsOfRoutes(const vector<string>& route_names) const {
+    vector<size_t> route_indexes;
+    route_indexes.reserve(route_names.size());
+    for (const string& name: route_names) {
+        const size_t index = FindRouteIndex(name);
+        if (index == NPOS) {
+            return nullopt;
+        }
+        route_indexes.push_back(index);
+    }
+    vector<string_view> ret;
+    if (route_stops_.Empty()) {
+        return ret;
+    }
+    for (const uint32_t stop_id: bitset_index::SetBits(route_stops_.OrRows(route_indexes))) {
+        ret.push_back(stops_[stop_id].name);
+    }
+    sort(ret.begin(), ret.end());
+    return ret;
+}
 
+void TransportCatalogue::BuildSpatialIndex() {
+    vector<geo::Coordinates> points;
+    points.reserve(stops_.size());
+    for (const domain::Stop& stop: stops_) {
+        points.push_back(stop.point);
+    }
+    stop_grid_ = spatial_index::GeoGrid(points);
+}
+
+void TransportCatalogue::SetSpatialIndex(spatial_index::GeoGrid stop_grid) {
+    stop_grid_ = std::move(stop_grid);
+}
+
+const spatial_index::GeoGrid& TransportCatalogue::GetSpatialIndex() const {
+    return stop_grid_;
+}
+
+vector<spatial_index::Neighbour> TransportCatalogue::FindNearbyStops(geo::Coordinates point, double radius,
+                                                                     size_t count) const {
+    return stop_grid_.FindNearby(point, radius, count);
+}
+
+TransportCatalogue::TotalDistanceCuravature
+TransportCatalogue::ComputeTotalDistanceCurvature(const domain::Bus* route) const {
+    if (route->route.empty()) {
+        return {};
+    }
+    const double total_distance = route->total_road_distance;
+    const double total_computed_distance = route->total_geo_distance;
+    const double curvature = (total_computed_distance != 0) ? total_distance / total_computed_distance : 0;
     return {total_distance, curvature};
 }
 
@@ -103,7 +328,107 @@ domain::RouteStats TransportCatalogue::ComputeRouteStats(const domain::Bus* rout
         total_stops = total_stops * 2 - 1;
     }
     const TransportCatalogue::TotalDistanceCuravature dist_curv = ComputeTotalDistanceCurvature(route);
-    return {dist_curv.total_distance, total_stops, static_cast<int>(route->unique_stops.size()), dist_curv.curvature};
+    return {dist_curv.total_distance, total_stops, route->unique_stop_count, dist_curv.curvature};
+}
+
+void TransportCatalogue::ComputeRouteDistances(domain::Bus& route) const {
+    const size_t stop_count = route.route.size();
+    route.road_distances.assign(stop_count, .0);
+    route.geo_distances.assign(stop_count, .0);
+    route.road_distances_back.assign(route.is_roundtrip ? 0 : stop_count, .0);
+
+    for (size_t i = 1; i < stop_count; ++i) {
+        const domain::Distances distances = GetDistance(&stops_[route.route[i - 1]], &stops_[route.route[i]]);
+        route.road_distances[i] = route.road_distances[i - 1] + distances.path_distance;
+        route.geo_distances[i] = route.geo_distances[i - 1] + distances.geo_distance;
+    }
+    route.total_road_distance = stop_count != 0 ? route.road_distances.back() : .0;
+    route.total_geo_distance = stop_count != 0 ? route.geo_distances.back() : .0;
+    if (route.is_roundtrip || stop_count == 0) {
+        return;
+    }
+
+    // Обратный путь начинается с разворота на конечной. Сумма по прямой продолжает прямой путь, а не складывается
+    // из двух сумм: так она совпадает побитово с суммой по всем перегонам подряд
+    const domain::Stop* last_stop = &stops_[route.route.back()];
+    const domain::Distances turnaround = GetDistance(last_stop, last_stop);
+    route.total_road_distance += turnaround.path_distance;
+    route.total_geo_distance += turnaround.geo_distance;
+    for (size_t i = 1; i < stop_count; ++i) {
+        const size_t back_index = stop_count - i;
+        const domain::Distances distances =
+            GetDistance(&stops_[route.route[back_index]], &stops_[route.route[back_index - 1]]);
+        route.road_distances_back[i] = route.road_distances_back[i - 1] + distances.path_distance;
+        route.total_road_distance += distances.path_distance;
+        route.total_geo_distance += distances.geo_distance;
+    }
+}
+
+void TransportCatalogue::ComputeRoutesParallel(size_t first_route) {
+    static const size_t MIN_ROUTES_PER_THREAD = 64;
+    parallel::ForEachRange(first_route, routes_.size(), MIN_ROUTES_PER_THREAD, [this](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            ComputeRouteDistances(routes_[i]);
+            route_stats_[i] = ComputeRouteStats(&routes_[i]);
+        }
+    });
+}
+
+size_t TransportCatalogue::FindStopIndex(std::string_view stop_name) const {
+    if (!stop_name_index_.Empty()) {
+        const size_t index = stop_name_index_.Find(stop_name);
+        return (index < stops_.size() && stops_[index].name == stop_name) ? index : NPOS;
+    }
+    const auto it = name_to_stop_index_.find(stop_name);
+    return (it != name_to_stop_index_.end()) ? it->second : NPOS;
+}
+
+size_t TransportCatalogue::FindRouteIndex(std::string_view route_name) const {
+    if (!route_name_index_.Empty()) {
+        const size_t index = route_name_index_.Find(route_name);
+        return (index < routes_.size() && routes_[index].name == route_name) ? index : NPOS;
+    }
+    const auto it = name_to_route_index_.find(route_name);
+    return (it != name_to_route_index_.end()) ? it->second : NPOS;
+}
+
+memory_usage::MemoryReport TransportCatalogue::MemoryUsage() const {
+    using namespace memory_usage;
+    MemoryReport ret;
+
+    size_t stops_bytes = DequeBytes(stops_);
+    for (const domain::Stop& stop: stops_) {
+        stops_bytes += StringHeapBytes(stop.name);
+    }
+    ret.Add("stops"s, stops_bytes);
+
+    size_t routes_bytes = DequeBytes(routes_);
+    for (const domain::Bus& route: routes_) {
+        routes_bytes += StringHeapBytes(route.name) + VectorBytes(route.route) + VectorBytes(route.road_distances) +
+                        VectorBytes(route.road_distances_back) + VectorBytes(route.geo_distances);
+    }
+    ret.Add("routes"s, routes_bytes);
+    ret.Add("route_stats"s, VectorBytes(route_stats_));
+
+    size_t stop_buses_bytes = VectorBytes(stop_unique_buses_);
+    for (const set<string_view>& buses: stop_unique_buses_) {
+        stop_buses_bytes += SetBytes(buses);
+    }
+    ret.Add("stop_unique_buses"s, stop_buses_bytes);
+
+    size_t distances_bytes = UnorderedMapBytes(stop_to_stop_real_distances_);
+    for (const auto& [stop, distances]: stop_to_stop_real_distances_) {
+        distances_bytes += UnorderedMapBytes(distances);
+    }
+    ret.Add("stop_distances"s, distances_bytes);
+
+    ret.Add("name_to_stop_index"s, UnorderedMapBytes(name_to_stop_index_));
+    ret.Add("name_to_route_index"s, UnorderedMapBytes(name_to_route_index_));
+    ret.Add("name_index"s, stop_name_index_.MemoryUsage() + route_name_index_.MemoryUsage());
+    ret.Add("prefix_index"s, VectorBytes(stops_by_name_) + VectorBytes(routes_by_name_));
+    ret.Add("spatial_index"s, stop_grid_.MemoryUsage());
+    ret.Add("membership_index"s, stop_routes_.MemoryUsage() + route_stops_.MemoryUsage());
+    return ret;
 }
 
 } // namespace transport_routine::catalogue
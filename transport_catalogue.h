@@ -1,16 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
 #include <string_view>
 #include <deque>
 #include <functional>
+#include <optional>
 #include <set>
 #include <stdexcept>
+#include <vector>
 
+#include "bitset_index.h"
 #include "geo.h"
+#include "memory_usage.h"
 #include "domain.h"
+#include "perfect_hash.h"
+#include "spatial_index.h"
 
 namespace transport_routine::catalogue {
 
@@ -27,10 +35,22 @@ public:
     void AddStop(const domain::Stop& stop);
     void AddRoute(const domain::Bus& route);
 
+    // Между BeginBulkLoad и EndBulkLoad статистика маршрутов не считается при добавлении,
+    // EndBulkLoad вычисляет её для всех добавленных маршрутов параллельно.
+    void BeginBulkLoad();
+    void EndBulkLoad();
+
+    // Загрузка сохранённой базы: маршрут добавляется с готовой статистикой,
+    // принадлежность остановок маршрутам восстанавливается отдельно через RestoreStopUniqueBuses.
+    // Накопленные расстояния маршрута вычисляются заново, поэтому остановки и расстояния восстанавливаются раньше.
+    void RestoreRoute(const domain::Bus& route, const domain::RouteStats& stats);
+    void RestoreStopUniqueBuses(const domain::Stop* stop, const std::vector<const domain::Bus*>& buses);
+
     void SetDistance(const domain::Stop* from, const domain::Stop* dest, int distance);
     domain::Distances GetDistance(const domain::Stop* from, const domain::Stop* dest) const;
 
     const domain::Stop* FindStop(std::string_view stop_name) const;
+    const domain::Stop& GetStop(domain::StopId stop_id) const;
     const domain::Bus* FindRoute(std::string_view route_name) const;
     const domain::RouteStats* FindRouteStats(std::string_view route_name) const;
     const std::set<std::string_view>* FindStopUniqueBuses(std::string_view stop_name) const;
@@ -39,13 +59,65 @@ public:
     const std::deque<domain::Stop>* GetAllStops() const;
     const std::unordered_map<const domain::Stop*, int>* GetStopDistances(const domain::Stop* stop) const;
 
+    // Строит совершенные хеш-функции по именам остановок и маршрутов. Вызывается после загрузки всей базы,
+    // любое последующее добавление остановки или маршрута сбрасывает индекс. Построенный индекс заменяет
+    // хеш-таблицы имён: они освобождаются и восстанавливаются только при сбросе индекса.
+    void BuildNameIndex();
+    void SetNameIndex(perfect_hash::PerfectHash stop_name_index, perfect_hash::PerfectHash route_name_index);
+
+    const perfect_hash::PerfectHash& GetStopNameIndex() const;
+    const perfect_hash::PerfectHash& GetRouteNameIndex() const;
+
+    // Префиксный индекс: идентификаторы остановок и порядковые номера маршрутов, упорядоченные по имени
+    // (для повторяющихся имён остаётся первый). Строится после загрузки базы, добавление сбрасывает индекс.
+    void BuildPrefixIndex();
+    void SetPrefixIndex(std::vector<uint32_t> stops_by_name, std::vector<uint32_t> routes_by_name);
+    const std::vector<uint32_t>& GetStopsByName() const;
+    const std::vector<uint32_t>& GetRoutesByName() const;
+
+    // Не более limit имён, начинающихся с prefix, в лексикографическом порядке
+    std::vector<std::string_view> SuggestStops(std::string_view prefix, size_t limit) const;
+    std::vector<std::string_view> SuggestRoutes(std::string_view prefix, size_t limit) const;
+
+    // Битовые множества принадлежности: для каждой остановки — маршруты, проходящие через неё,
+    // для каждого маршрута — его остановки. Строятся после загрузки базы, добавление сбрасывает индекс.
+    void BuildMembershipIndex();
+
+    // Маршруты, проходящие через все остановки stop_names, и остановки хотя бы одного из маршрутов route_names,
+    // упорядоченные по имени. nullopt, если какая-то из перечисленных остановок или маршрутов не найдена
+    std::optional<std::vector<std::string_view>> FindCommonRoutes(const std::vector<std::string>& stop_names) const;
+    std::optional<std::vector<std::string_view>> FindStopsOfRoutes(const std::vector<std::string>& route_names) const;
+
+    // Пространственный индекс остановок. Строится после загрузки всех остановок,
+    // добавление остановки сбрасывает индекс.
+    void BuildSpatialIndex();
+    void SetSpatialIndex(spatial_index::GeoGrid stop_grid);
+    const spatial_index::GeoGrid& GetSpatialIndex() const;
+
+    // Остановки не дальше radius метров от point, не более count (0 — без ограничения), по возрастанию расстояния
+    std::vector<spatial_index::Neighbour> FindNearbyStops(geo::Coordinates point, double radius, size_t count) const;
+
+    // Занимаемая память по структурам каталога
+    memory_usage::MemoryReport MemoryUsage() const;
+
 private:
+    static constexpr size_t NPOS = perfect_hash::PerfectHash::NPOS;
+
     std::deque<domain::Stop> stops_;
     std::deque<domain::Bus> routes_;
-    std::unordered_map<std::string_view, const domain::Stop*> name_to_stop_index_;
-    std::unordered_map<std::string_view, const domain::Bus*> name_to_route_index_;
-    std::unordered_map<std::string_view, domain::RouteStats> name_to_route_stats_;
-    std::unordered_map<std::string_view, std::set<std::string_view>> name_to_stop_unique_buses_;
+    std::vector<domain::RouteStats> route_stats_;
+    std::vector<std::set<std::string_view>> stop_unique_buses_;
+    std::unordered_map<std::string_view, size_t> name_to_stop_index_;
+    std::unordered_map<std::string_view, size_t> name_to_route_index_;
+    perfect_hash::PerfectHash stop_name_index_;
+    perfect_hash::PerfectHash route_name_index_;
+    spatial_index::GeoGrid stop_grid_;
+    std::vector<uint32_t> stops_by_name_;
+    std::vector<uint32_t> routes_by_name_;
+    bitset_index::BitMatrix stop_routes_;
+    bitset_index::BitMatrix route_stops_;
+    bool is_bulk_load_ = false;
+    size_t bulk_load_first_route_ = 0;
     std::unordered_map<const domain::Stop*, std::unordered_map<const domain::Stop*, int>> stop_to_stop_real_distances_;
 
     struct TotalDistanceCuravature {
@@ -55,6 +127,54 @@ private:
 
     TotalDistanceCuravature ComputeTotalDistanceCurvature(const domain::Bus* route) const;
     domain::RouteStats ComputeRouteStats(const domain::Bus* route) const;
+    void ComputeRouteDistances(domain::Bus& route) const;
+    void ComputeRoutesParallel(size_t first_route);
+
+    template <typename Container>
+    static std::vector<uint32_t> SortByName(const Container& items);
+    template <typename Container>
+    static std::vector<std::string_view> FindByPrefix(const Container& items, const std::vector<uint32_t>& by_name,
+                                                      std::string_view prefix, size_t limit);
+
+    size_t FindStopIndex(std::string_view stop_name) const;
+    size_t FindRouteIndex(std::string_view route_name) const;
+
+    void ReleaseNameMaps();
+    void ResetStopNameIndex();
+    void ResetRouteNameIndex();
 };
 
+template <typename Container>
+std::vector<uint32_t> TransportCatalogue::SortByName(const Container& items) {
+    std::vector<uint32_t> ret(items.size());
+    for (uint32_t i = 0; i < ret.size(); ++i) {
+        ret[i] = i;
+    }
+    std::stable_sort(ret.begin(), ret.end(), [&items](uint32_t lhs, uint32_t rhs) {
+        return items[lhs].name < items[rhs].name;
+    });
+    ret.erase(std::unique(ret.begin(), ret.end(), [&items](uint32_t lhs, uint32_t rhs) {
+        return items[lhs].name == items[rhs].name;
+    }), ret.end());
+    return ret;
+}
+
+template <typename Container>
+std::vector<std::string_view> TransportCatalogue::FindByPrefix(const Container& items,
+                                                               const std::vector<uint32_t>& by_name,
+                                                               std::string_view prefix, size_t limit) {
+    std::vector<std::string_view> ret;
+    auto it = std::lower_bound(by_name.begin(), by_name.end(), prefix, [&items](uint32_t id, std::string_view value) {
+        return std::string_view(items[id].name) < value;
+    });
+    for (; it != by_name.end() && ret.size() < limit; ++it) {
+        const std::string_view name = items[*it].name;
+        if (name.substr(0, prefix.size()) != prefix) {
+            break;
+        }
+        ret.push_back(name);
+    }
+    return ret;
+}
+
 } // namespace transport_routine::catalogue
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "transport_router.h"
 
+#include <algorithm>
+
+#include "parallel.h"
+
 namespace transport_router {
 
 TransportRouter::TransportRouterBuilder::TransportRouterBuilder(
@@ -47,15 +51,20 @@ void TransportRouter::TransportRouterBuilder::AddStopsToGraph() {
 }
 
 void TransportRouter::TransportRouterBuilder::AddBusesToGraph() {
+    using namespace std::literals;
+
     if (catalogue_.GetAllRoutes()) {
         for (const transport_routine::domain::Bus& bus : *catalogue_.GetAllRoutes()) {
-            std::deque<const transport_routine::domain::Stop*> route_for_processing(bus.route.begin(), bus.route.end());
-
-            if (!route_for_processing.empty()) {
-                AddOneWayRouteToGraph(route_for_processing.begin(), route_for_processing.end(), bus);
-                if (!bus.is_roundtrip) {
-                    AddOneWayRouteToGraph(route_for_processing.rbegin(), route_for_processing.rend(), bus);
-                }
+            if (bus.route.empty()) {
+                continue;
+            }
+            if (bus.road_distances.size() != bus.route.size() ||
+                (!bus.is_roundtrip && bus.road_distances_back.size() != bus.route.size())) {
+                throw std::logic_error("Route distances are not computed for bus "s + bus.name);
+            }
+            AddOneWayRouteToGraph(bus.route.begin(), bus.route.end(), bus.road_distances, bus);
+            if (!bus.is_roundtrip) {
+                AddOneWayRouteToGraph(bus.route.rbegin(), bus.route.rend(), bus.road_distances_back, bus);
             }
         }
     }
@@ -118,6 +127,58 @@ Route TransportRouter::GetRoute(std::string_view from, std::string_view to) cons
     return {std::move(ret), route->weight, true};
 }
 
+std::optional<std::vector<ReachableStop>> TransportRouter::GetReachableStops(std::string_view from,
+                                                                            double max_time) const {
+    const std::optional<graph::VertexId> from_vertex = FindTerminalVertex(from);
+    if (!from_vertex) {
+        return std::nullopt;
+    }
+
+    std::vector<ReachableStop> ret;
+    const auto& routes_from = router_.GetRoutesInternalData().at(*from_vertex);
+    for (const auto& [stop_ptr, vertexes] : stop_to_vertex_index_) {
+        const auto& route = routes_from[vertexes.terminal];
+        if (route && route->weight <= max_time) {
+            ret.push_back({stop_ptr->name, route->weight});
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](const ReachableStop& lhs, const ReachableStop& rhs) {
+        return lhs.time < rhs.time || (lhs.time == rhs.time && lhs.name < rhs.name);
+    });
+
+    return ret;
+}
+
+std::vector<std::vector<std::optional<double>>> TransportRouter::GetTravelTimes(
+    const std::vector<std::string>& from, const std::vector<std::string>& to) const {
+    static const size_t MIN_ROWS_PER_THREAD = 16;
+    std::vector<std::optional<graph::VertexId>> to_vertexes;
+    to_vertexes.reserve(to.size());
+    for (const std::string& stop_name : to) {
+        to_vertexes.push_back(FindTerminalVertex(stop_name));
+    }
+
+    std::vector<std::vector<std::optional<double>>> ret(from.size());
+    parallel::ForEachRange(0, from.size(), MIN_ROWS_PER_THREAD, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            std::vector<std::optional<double>>& row = ret[i];
+            row.resize(to_vertexes.size());
+            const std::optional<graph::VertexId> from_vertex = FindTerminalVertex(from[i]);
+            if (!from_vertex) {
+                continue;
+            }
+            const auto& routes_from = router_.GetRoutesInternalData()[*from_vertex];
+            for (size_t j = 0; j < to_vertexes.size(); ++j) {
+                if (to_vertexes[j] && routes_from[*to_vertexes[j]]) {
+                    row[j] = routes_from[*to_vertexes[j]]->weight;
+                }
+            }
+        }
+    });
+
+    return ret;
+}
+
 const RoutingSettings& TransportRouter::GetRoutingSettings() const { return settings_; }
 
 const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraph() const { return graph_; }
@@ -132,4 +193,25 @@ RouterEssentials TransportRouter::GetRouterEssentials() const {
 
 const graph::Router<double>& TransportRouter::GetRouter() const { return router_; }
 
+memory_usage::MemoryReport TransportRouter::MemoryUsage() const {
+    memory_usage::MemoryReport ret;
+    ret.Merge("graph", graph_.MemoryUsage());
+    ret.Merge("router", router_.MemoryUsage());
+    ret.Add("stop_to_vertex_index", memory_usage::UnorderedMapBytes(stop_to_vertex_index_));
+    size_t route_items_bytes = memory_usage::UnorderedMapBytes(edge_to_route_item_index_);
+    for (const auto& [edge, item] : edge_to_route_item_index_) {
+        route_items_bytes += memory_usage::StringHeapBytes(item.name);
+    }
+    ret.Add("edge_to_route_item_index", route_items_bytes);
+    return ret;
+}
+
+std::optional<graph::VertexId> TransportRouter::FindTerminalVertex(std::string_view stop_name) const {
+    const transport_routine::domain::Stop* stop_ptr = catalogue_.FindStop(stop_name);
+    if (!stop_ptr) {
+        return std::nullopt;
+    }
+    return stop_to_vertex_index_.at(stop_ptr).terminal;
+}
+
 }  // namespace transport_router
@@ -12,6 +12,7 @@
 
 #include "domain.h"
 #include "graph.h"
+#include "memory_usage.h"
 #include "router.h"
 #include "transport_catalogue.h"
 
@@ -39,6 +40,11 @@ struct Route {
     operator bool() const { return IsSuccess; }
 };
 
+struct ReachableStop {
+    std::string_view name;
+    double time = .0;
+};
+
 struct Vertexes {
     graph::VertexId terminal = 0;
     graph::VertexId on_route = 0;
@@ -74,7 +80,8 @@ class TransportRouter {
         void AddBusesToGraph();
 
         template <typename InputIt>
-        void AddOneWayRouteToGraph(InputIt first, InputIt last, const transport_routine::domain::Bus& bus);
+        void AddOneWayRouteToGraph(InputIt first, InputIt last, const std::vector<double>& road_distances,
+                                   const transport_routine::domain::Bus& bus);
 
         double ComputeTimeMinutes(double distance_m) const;
     };
@@ -90,6 +97,16 @@ class TransportRouter {
 
     Route GetRoute(std::string_view from, std::string_view to) const;
 
+    // Остановки, до которых можно доехать из from не более чем за max_time минут, по возрастанию времени.
+    // Отвечает одним проходом по строке таблицы маршрутизатора для from. std::nullopt — остановка не найдена.
+    std::optional<std::vector<ReachableStop>> GetReachableStops(std::string_view from, double max_time) const;
+
+    // Матрица времён в пути: строка на каждую остановку from, столбец на каждую остановку to.
+    // std::nullopt — остановка не найдена или маршрута нет. Строки заполняются параллельно
+    // выборкой из таблицы маршрутизатора.
+    std::vector<std::vector<std::optional<double>>> GetTravelTimes(const std::vector<std::string>& from,
+                                                                   const std::vector<std::string>& to) const;
+
     const RoutingSettings& GetRoutingSettings() const;
 
     const graph::DirectedWeightedGraph<double>& GetGraph() const;
@@ -98,6 +115,8 @@ class TransportRouter {
 
     const graph::Router<double>& GetRouter() const;
 
+    memory_usage::MemoryReport MemoryUsage() const;
+
    private:
     const transport_routine::catalogue::TransportCatalogue& catalogue_;
     graph::DirectedWeightedGraph<double> graph_;
@@ -106,22 +125,22 @@ class TransportRouter {
 
     std::unordered_map<const transport_routine::domain::Stop*, Vertexes> stop_to_vertex_index_;
     std::unordered_map<graph::EdgeId, RouteItem> edge_to_route_item_index_;
+
+    std::optional<graph::VertexId> FindTerminalVertex(std::string_view stop_name) const;
 };
 
 template <typename InputIt>
 void TransportRouter::TransportRouterBuilder::AddOneWayRouteToGraph(InputIt first, InputIt last,
+                                                                    const std::vector<double>& road_distances,
                                                                     const transport_routine::domain::Bus& bus) {
     for (auto it_from = first; it_from != last - 1; ++it_from) {
-        double total_distance = .0;
-        const transport_routine::domain::Stop* previous_stop = *it_from;
+        const double distance_from = road_distances[it_from - first];
+        const graph::VertexId vertex_from = stop_to_vertex_index_.at(&catalogue_.GetStop(*it_from)).on_route;
         for (auto it_to = it_from + 1; it_to != last; ++it_to) {
             size_t span = std::abs(it_to - it_from);
-            const transport_routine::domain::Distances distances = catalogue_.GetDistance(previous_stop, *it_to);
-            total_distance += distances.path_distance;
-            previous_stop = *it_to;
-            double time = ComputeTimeMinutes(total_distance);
-            graph::EdgeId edge = graph_.AddEdge(
-                {stop_to_vertex_index_.at(*it_from).on_route, stop_to_vertex_index_.at(*it_to).terminal, time});
+            double time = ComputeTimeMinutes(road_distances[it_to - first] - distance_from);
+            const graph::VertexId vertex_to = stop_to_vertex_index_.at(&catalogue_.GetStop(*it_to)).terminal;
+            graph::EdgeId edge = graph_.AddEdge({vertex_from, vertex_to, time});
             RouteItem item = {RouteItemType::BUS, bus.name, time, span};
             edge_to_route_item_index_.insert({edge, item});
         }